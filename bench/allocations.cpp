@@ -0,0 +1,30 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// The replacements live in their own translation unit, so the compiler
+// cannot inline them into one side of a new/delete pair and see malloc or
+// free paired with the library's operators.
+
+std::atomic<unsigned long> allocations(0);
+
+void * operator new(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void * p = std::malloc(size ? size : 1))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept
+{
+	std::free(p);
+}
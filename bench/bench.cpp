@@ -0,0 +1,328 @@
+#include <cpp_sgr/format.hpp>
+#include <cpp_sgr/sgr.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace cpp_sgr;
+
+/**
+ * Number of allocations made through the global operator new, which is
+ * replaced in allocations.cpp
+ */
+extern std::atomic<unsigned long> allocations;
+
+/**
+ * std::streambuf discarding everything written to it, counting the bytes.
+ */
+class null_buffer : public std::streambuf
+{
+public:
+	std::size_t written = 0;
+
+protected:
+	std::streamsize xsputn(const char *, std::streamsize count) override
+	{
+		written += static_cast<std::size_t>(count);
+		return count;
+	}
+
+	int_type overflow(int_type c) override
+	{
+		++written;
+		return traits_type::not_eof(c);
+	}
+};
+
+/**
+ * Output a benchmark writes to, recreated for each batch of operations.
+ */
+struct sink
+{
+	const char * name;
+	std::function<void(std::ostream *&)> open;
+	std::function<void(std::ostream *&)> rewind;
+};
+
+/**
+ * Operation measured by a benchmark.
+ */
+struct benchmark
+{
+	const char * name;
+	std::function<void(std::ostream &, unsigned)> run;
+};
+
+/**
+ * Measurement of one benchmark against one sink.
+ */
+struct result
+{
+	std::string benchmark;
+	std::string sink;
+	double nsPerOp;
+	double relative;
+	double bytesPerOp;
+	double allocationsPerOp;
+};
+
+static const unsigned BATCH = 1000;
+static const unsigned BATCHES = 200;
+static const unsigned REPETITIONS = 5;
+
+/**
+ * Benchmark writing the bytes of insert_sgr with plain string insertions.
+ * Times are compared relative to it on the same sink, so the comparison does
+ * not depend on the speed of the machine.
+ */
+static const char * const REFERENCE = "plain_escape";
+
+/**
+ * Measure a benchmark, keeping the fastest of several repetitions.
+ */
+static result measure(const benchmark & b, const sink & s)
+{
+	std::ostream * out = nullptr;
+	s.open(out);
+
+	// Bytes per operation, counted once
+	null_buffer counter;
+	std::ostream counted(&counter);
+	for (unsigned i = 0; i < BATCH; ++i)
+	{
+		b.run(counted, i);
+	}
+
+	double best = 1e30;
+	unsigned long allocated = 0;
+	for (unsigned repetition = 0; repetition < REPETITIONS; ++repetition)
+	{
+		std::chrono::nanoseconds elapsed(0);
+		const unsigned long allocationsBefore = allocations.load();
+		for (unsigned batch = 0; batch < BATCHES; ++batch)
+		{
+			s.rewind(out);
+			const auto start = std::chrono::steady_clock::now();
+			for (unsigned i = 0; i < BATCH; ++i)
+			{
+				b.run(*out, i);
+			}
+			elapsed += std::chrono::steady_clock::now() - start;
+		}
+		allocated = allocations.load() - allocationsBefore;
+		best = std::min(best,
+						double(elapsed.count()) / (double(BATCH) * BATCHES));
+	}
+
+	delete out;
+	return result{b.name, s.name, best, 1.0, double(counter.written) / BATCH,
+				  double(allocated) / (double(BATCH) * BATCHES)};
+}
+
+static std::vector<result> runAll()
+{
+	static null_buffer discard;
+	const sink sinks[] = {
+		{"ostringstream",
+		 [](std::ostream *& out) { out = new std::ostringstream(); },
+		 [](std::ostream *& out) { out->seekp(0); }},
+		{"null_streambuf",
+		 [](std::ostream *& out) { out = new std::ostream(&discard); },
+		 [](std::ostream *&) {}},
+		{"dev_null",
+#ifdef _WIN32
+		 [](std::ostream *& out) { out = new std::ofstream("NUL"); },
+#else
+		 [](std::ostream *& out) { out = new std::ofstream("/dev/null"); },
+#endif
+		 [](std::ostream *&) {}}};
+
+	// The first benchmark is the reference the others are timed against
+	const benchmark benchmarks[] = {
+		{REFERENCE,
+		 [](std::ostream & out, unsigned) {
+			 out << "\x1b[31m" << 'x' << "\x1b[0m";
+		 }},
+		{"insert_sgr",
+		 [](std::ostream & out, unsigned) { out << red_fg << 'x'; }},
+		{"insert_combined",
+		 [](std::ostream & out, unsigned) {
+			 out << bold + underline + red_fg + b_blue_bg << 'x';
+		 }},
+		{"color_rgb",
+		 [](std::ostream & out, unsigned i) {
+			 out << color::fg(int(i & 0xFF), int(i >> 2 & 0xFF), 128) << 'x';
+		 }},
+		{"wrapper_lifecycle",
+		 [](std::ostream & out, unsigned) {
+			 sgr_ostream_wrapper wrapper(out);
+			 sgr_ostream_wrapper moved(std::move(wrapper));
+		 }},
+		{"reset",
+		 [](std::ostream & out, unsigned) { out << reset << 'x'; }},
+		{"insert_value",
+		 [](std::ostream & out, unsigned i) { out << red_fg << i; }},
+		{"styled_value",
+		 [](std::ostream & out, unsigned i) { out << styled(red_fg, i); }},
+#if CPP_SGR_HAS_FORMAT
+		{"format_to",
+		 [](std::ostream & out, unsigned i) {
+			 std::format_to(std::ostreambuf_iterator<char>(out), "{}",
+							styled(red_fg, i));
+		 }},
+#endif
+	};
+
+	std::vector<result> results;
+	for (const benchmark & b : benchmarks)
+	{
+		for (const sink & s : sinks)
+		{
+			results.push_back(measure(b, s));
+		}
+	}
+
+	const std::size_t sinkCount = sizeof(sinks) / sizeof(sinks[0]);
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		results[i].relative =
+			results[i].nsPerOp / results[i % sinkCount].nsPerOp;
+	}
+	return results;
+}
+
+static void print(const std::vector<result> & results, std::FILE * file)
+{
+	std::fprintf(file, "benchmark,sink,ns_per_op,relative,bytes_per_op,"
+					   "allocs_per_op\n");
+	for (const result & r : results)
+	{
+		std::fprintf(file, "%s,%s,%.2f,%.2f,%.2f,%.3f\n", r.benchmark.c_str(),
+					 r.sink.c_str(), r.nsPerOp, r.relative, r.bytesPerOp,
+					 r.allocationsPerOp);
+	}
+}
+
+static bool readBaseline(const char * path, std::vector<result> & baseline)
+{
+	std::ifstream file(path);
+	std::string line;
+	if (!std::getline(file, line))
+	{
+		return false;
+	}
+	while (std::getline(file, line))
+	{
+		std::istringstream fields(line);
+		result r;
+		std::string value;
+		std::getline(fields, r.benchmark, ',');
+		std::getline(fields, r.sink, ',');
+		std::getline(fields, value, ',');
+		r.nsPerOp = std::atof(value.c_str());
+		std::getline(fields, value, ',');
+		r.relative = std::atof(value.c_str());
+		std::getline(fields, value, ',');
+		r.bytesPerOp = std::atof(value.c_str());
+		std::getline(fields, value, ',');
+		r.allocationsPerOp = std::atof(value.c_str());
+		if (!r.benchmark.empty())
+		{
+			baseline.push_back(r);
+		}
+	}
+	return true;
+}
+
+/**
+ * Compare results to a baseline. Output and allocations must match
+ * exactly, while time relative to the reference benchmark may grow by the
+ * given factor. Absolute times are only reported.
+ */
+static int check(const std::vector<result> & results,
+				 const char * path,
+				 const double threshold)
+{
+	std::vector<result> baseline;
+	if (!readBaseline(path, baseline))
+	{
+		std::fprintf(stderr, "cannot read baseline %s\n", path);
+		return 1;
+	}
+
+	int failures = 0;
+	for (const result & expected : baseline)
+	{
+		const auto found = std::find_if(
+			results.begin(), results.end(), [&expected](const result & r) {
+				return r.benchmark == expected.benchmark &&
+					   r.sink == expected.sink;
+			});
+		if (found == results.end())
+		{
+			std::fprintf(stderr, "%s,%s: missing\n",
+						 expected.benchmark.c_str(), expected.sink.c_str());
+			++failures;
+			continue;
+		}
+		if (found->relative > expected.relative * threshold ||
+			found->bytesPerOp > expected.bytesPerOp + 0.005 ||
+			found->allocationsPerOp > expected.allocationsPerOp + 0.0005)
+		{
+			std::fprintf(stderr,
+						 "%s,%s: regressed to %.2f times the reference, "
+						 "%.2f bytes, %.3f allocations per op (baseline "
+						 "%.2f, %.2f, %.3f)\n",
+						 expected.benchmark.c_str(), expected.sink.c_str(),
+						 found->relative, found->bytesPerOp,
+						 found->allocationsPerOp, expected.relative,
+						 expected.bytesPerOp, expected.allocationsPerOp);
+			++failures;
+		}
+	}
+	return failures == 0 ? 0 : 1;
+}
+
+/**
+ * Run all benchmarks and print the results as CSV. With
+ * --check <baseline.csv> [--threshold <factor>], fail if any benchmark is
+ * slower relative to the reference benchmark than in the baseline by more
+ * than the factor (default 3), or emits more bytes or allocates more.
+ */
+int main(int argc, char ** argv)
+{
+	const char * baseline = nullptr;
+	double threshold = 3.0;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--check") == 0 && i + 1 < argc)
+		{
+			baseline = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+		{
+			threshold = std::atof(argv[++i]);
+		}
+		else
+		{
+			std::fprintf(stderr,
+						 "usage: %s [--check baseline.csv [--threshold f]]\n",
+						 argv[0]);
+			return 2;
+		}
+	}
+
+	const std::vector<result> results = runAll();
+	print(results, stdout);
+	return baseline ? check(results, baseline, threshold) : 0;
+}
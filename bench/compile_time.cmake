@@ -0,0 +1,83 @@
+# Measure the compile time and the number of static initializers of a
+# translation unit including each cpp_sgr header.
+#
+# Run in script mode with CXX, INCLUDE_DIR and WORK_DIR defined, and
+# optionally OBJDUMP and REPEAT (default 5). With GIT and SOURCE_DIR defined,
+# the "pre_split" case compiles sgr.hpp as of PRE_SPLIT_REVISION (default: the
+# baseline commit a75774d), before it was split into core.hpp and ostream.hpp.
+# Results are printed and written to WORK_DIR/compile_time.csv.
+
+if(NOT REPEAT)
+  set(REPEAT 5)
+endif()
+if(NOT PRE_SPLIT_REVISION)
+  set(PRE_SPLIT_REVISION a75774d)
+endif()
+
+set(cases core ostream sgr)
+set(core_includes "#include <cpp_sgr/core.hpp>")
+set(ostream_includes "#include <cpp_sgr/ostream.hpp>")
+set(sgr_includes "#include <cpp_sgr/sgr.hpp>")
+set(core_include_dir ${INCLUDE_DIR})
+set(ostream_include_dir ${INCLUDE_DIR})
+set(sgr_include_dir ${INCLUDE_DIR})
+
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+if(GIT AND SOURCE_DIR)
+  execute_process(
+    COMMAND ${GIT} show ${PRE_SPLIT_REVISION}:include/cpp_sgr/sgr.hpp
+    WORKING_DIRECTORY ${SOURCE_DIR}
+    OUTPUT_VARIABLE pre_split_header
+    RESULT_VARIABLE failed
+    ERROR_QUIET)
+  if(NOT failed)
+    file(WRITE ${WORK_DIR}/pre_split/cpp_sgr/sgr.hpp "${pre_split_header}")
+    list(APPEND cases pre_split)
+    set(pre_split_includes "#include <cpp_sgr/sgr.hpp>")
+    set(pre_split_include_dir ${WORK_DIR}/pre_split)
+  endif()
+endif()
+if(NOT pre_split_include_dir)
+  message("pre_split: skipped, ${PRE_SPLIT_REVISION} is not available")
+endif()
+
+set(csv "header,ms_per_tu,static_initializers\n")
+
+foreach(case ${cases})
+  set(source ${WORK_DIR}/${case}.cpp)
+  set(object ${WORK_DIR}/${case}.o)
+  file(WRITE ${source} "${${case}_includes}\nint ${case}_marker() { return 0; }\n")
+
+  set(best 0)
+  foreach(i RANGE 1 ${REPEAT})
+    string(TIMESTAMP start "%s%f" UTC)
+    execute_process(
+      COMMAND ${CXX} -std=c++11 -I${${case}_include_dir} -c ${source}
+        -o ${object}
+      RESULT_VARIABLE failed)
+    string(TIMESTAMP end "%s%f" UTC)
+    if(failed)
+      message(FATAL_ERROR "Compiling ${source} failed")
+    endif()
+    math(EXPR elapsed "(${end} - ${start}) / 1000")
+    if(best EQUAL 0 OR elapsed LESS best)
+      set(best ${elapsed})
+    endif()
+  endforeach()
+
+  # Each static initializer of a TU adds a pointer to .init_array
+  set(initializers "n/a")
+  if(OBJDUMP)
+    execute_process(COMMAND ${OBJDUMP} -h ${object} OUTPUT_VARIABLE sections)
+    set(initializers 0)
+    if(sections MATCHES "\\.init_array +([0-9a-fA-F]+)")
+      math(EXPR initializers "0x${CMAKE_MATCH_1} / 8")
+    endif()
+  endif()
+
+  message("${case}: ${best} ms, ${initializers} static initializers")
+  string(APPEND csv "${case},${best},${initializers}\n")
+endforeach()
+
+file(WRITE ${WORK_DIR}/compile_time.csv "${csv}")
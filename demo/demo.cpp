@@ -1,3 +1,4 @@
+#include <cpp_sgr/gradient.hpp>
 #include <cpp_sgr/sgr.hpp>
 
 #include <iomanip>
@@ -63,6 +64,23 @@ void iteratorTest()
 	}
 }
 
+/**
+ * Demonstrate gradient text
+ */
+
+void gradientTest()
+{
+	std::cout << (bold, underline) << "Testing gradients:\n";
+
+	gradient rainbow({rgb{255, 0, 0}, rgb{255, 255, 0}, rgb{0, 255, 0},
+					  rgb{0, 255, 255}, rgb{0, 0, 255}, rgb{255, 0, 255}});
+	rainbow.setStyle(bold);
+	std::cout << rainbow.render("Every character has its own color") << "\n";
+
+	const gradient meter(rgb{0, 0, 0}, rgb{0, 128, 255}, false);
+	std::cout << meter.render("\xe2\x96\x8f loading ") << "\n\n";
+}
+
 /**
  * Demonstrate SGRs that are not commonly supported; results may vary
  * depending on terminal emulator.
@@ -112,6 +130,7 @@ int main()
 	codeTest();
 	ansiTest();
 	iteratorTest();
+	gradientTest();
 	exoticTest();
 
 	return 0;
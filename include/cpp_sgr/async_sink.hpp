@@ -0,0 +1,527 @@
+/**
+ *  cpp_sgr asynchronous styled output sink.
+ *
+ *  @file async_sink.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_ASYNC_SINK_HPP
+#define CPP_SGR_ASYNC_SINK_HPP
+
+#include "styled_buffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+CPP_SGR_BEGIN_NAMESPACE
+	/**
+	 * Sink writing styled records to an output from a background thread.
+	 *
+	 * @class async_sink
+	 * Producers copy each record, a run of text together with the sgr it is
+	 * rendered in, into a slot of a bounded multi-producer ring buffer without
+	 * taking any lock. A single background thread drains ready records, at
+	 * most one ring buffer's worth at a time, into a styled_buffer, so
+	 * consecutive records in the same style share their escape sequences,
+	 * and writes each batch to the output in one call. Every batch ends in
+	 * the default rendition.
+	 *
+	 * When the ring buffer is full, producers either wait for a free slot or
+	 * drop the record, depending on the overflow policy. Waiting producers
+	 * yield for a bounded number of attempts, then sleep until the
+	 * background thread frees a slot. Records lost to failed writes are
+	 * counted rather than reported to their producers. Destroying the sink
+	 * writes all records accepted so far, followed by a reset, before
+	 * returning.
+	 *
+	 * Programs using this header must link against the platform's thread
+	 * library.
+	 */
+	class async_sink
+	{
+	public:
+		/**
+		 * Behaviors of write() when the ring buffer is full.
+		 */
+		enum OverflowPolicy
+		{
+			BLOCK, /**< Wait until a slot is free */
+			DROP   /**< Discard the record */
+		};
+
+		/**
+		 * Construct a sink writing to a file descriptor.
+		 *
+		 * @param fd         File descriptor to write to
+		 * @param capacity   Number of records the ring buffer holds; rounded
+		 * up to a power of two
+		 * @param policy     Behavior when the ring buffer is full
+		 * @param recordSize Bytes of text reserved per slot; longer records
+		 * are still accepted, at the cost of an allocation
+		 */
+		explicit async_sink(const int fd,
+							const std::size_t capacity = 1024,
+							const OverflowPolicy policy = BLOCK,
+							const std::size_t recordSize = 256) :
+			async_sink(FD_OUTPUT, capacity, policy, recordSize)
+		{
+			output.fd = fd;
+			start();
+		}
+
+		/**
+		 * Construct a sink writing to a C stream, which is flushed after
+		 * every batch.
+		 *
+		 * @param file       C stream to write to
+		 * @param capacity   Number of records the ring buffer holds
+		 * @param policy     Behavior when the ring buffer is full
+		 * @param recordSize Bytes of text reserved per slot
+		 */
+		explicit async_sink(std::FILE * file,
+							const std::size_t capacity = 1024,
+							const OverflowPolicy policy = BLOCK,
+							const std::size_t recordSize = 256) :
+			async_sink(FILE_OUTPUT, capacity, policy, recordSize)
+		{
+			output.file = file;
+			start();
+		}
+
+		/**
+		 * Construct a sink writing to a std::ostream, which is flushed after
+		 * every batch. The stream must not be written to by anything else
+		 * while the sink exists.
+		 *
+		 * @param stream     Stream to write to
+		 * @param capacity   Number of records the ring buffer holds
+		 * @param policy     Behavior when the ring buffer is full
+		 * @param recordSize Bytes of text reserved per slot
+		 */
+		explicit async_sink(std::ostream & stream,
+							const std::size_t capacity = 1024,
+							const OverflowPolicy policy = BLOCK,
+							const std::size_t recordSize = 256) :
+			async_sink(STREAM_OUTPUT, capacity, policy, recordSize)
+		{
+			output.stream = &stream;
+			start();
+		}
+
+		async_sink(const async_sink &) = delete;
+		async_sink & operator=(const async_sink &) = delete;
+
+		/**
+		 * Write all accepted records followed by a reset, then stop the
+		 * background thread. No records may be written concurrently.
+		 */
+		~async_sink()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping.store(true);
+			}
+			wakeup.notify_one();
+			writer.join();
+		}
+
+		/**
+		 * Queue a run of text rendered in the given sgr.
+		 *
+		 * @param  s      sgr to render the text in
+		 * @param  text   Text of the record
+		 * @param  length Length of the text in bytes
+		 * @return        True if the record was queued, false if it was
+		 * dropped
+		 */
+		bool write(const sgr & s, const char * text, const std::size_t length)
+		{
+			return enqueue(s.getStyle().effective(), text, length);
+		}
+
+		/**
+		 * Queue a run of text rendered in the given sgr.
+		 *
+		 * @param  s    sgr to render the text in
+		 * @param  text Text of the record
+		 * @return      True if the record was queued, false if it was dropped
+		 */
+		bool write(const sgr & s, const std::string & text)
+		{
+			return write(s, text.data(), text.size());
+		}
+
+		/**
+		 * Queue a run of text rendered in the default rendition.
+		 *
+		 * @param  text   Text of the record
+		 * @param  length Length of the text in bytes
+		 * @return        True if the record was queued, false if it was
+		 * dropped
+		 */
+		bool write(const char * text, const std::size_t length)
+		{
+			return enqueue(style(), text, length);
+		}
+
+		/**
+		 * Queue a run of text rendered in the default rendition.
+		 *
+		 * @param  text Text of the record
+		 * @return      True if the record was queued, false if it was dropped
+		 */
+		bool write(const std::string & text)
+		{
+			return write(text.data(), text.size());
+		}
+
+		/**
+		 * Block until every record queued before the call has been written.
+		 */
+		void flush()
+		{
+			const std::size_t target = enqueuePosition.load();
+			std::unique_lock<std::mutex> lock(mutex);
+			while (writtenPosition < target)
+			{
+				flushRequested = true;
+				wakeup.notify_one();
+				flushed.wait_for(lock, std::chrono::milliseconds(5));
+			}
+		}
+
+		/**
+		 * @return Number of records dropped because the ring buffer was full
+		 */
+		std::size_t dropped() const { return droppedCount.load(); }
+
+		/**
+		 * @return Number of records lost because writing their batch to the
+		 * output failed
+		 */
+		std::size_t failed() const { return failedCount.load(); }
+
+	private:
+		enum OutputKind
+		{
+			FD_OUTPUT,
+			FILE_OUTPUT,
+			STREAM_OUTPUT
+		};
+
+		/**
+		 * Ring buffer slot holding one record.
+		 */
+		struct slot
+		{
+			std::atomic<std::size_t> sequence;
+			style rendition;
+			std::string text;
+		};
+
+		/**
+		 * Common constructor; does not start the background thread.
+		 */
+		async_sink(const OutputKind kind,
+				   const std::size_t capacity,
+				   const OverflowPolicy policy,
+				   const std::size_t recordSize) :
+			kind(kind),
+			policy(policy), mask(roundCapacity(capacity) - 1),
+			slots(new slot[mask + 1]), batch(recordSize * 16)
+		{
+			for (std::size_t i = 0; i <= mask; ++i)
+			{
+				slots[i].sequence.store(i, std::memory_order_relaxed);
+				slots[i].text.reserve(recordSize);
+			}
+		}
+
+		/**
+		 * Number of times a producer yields on a full ring buffer before
+		 * sleeping.
+		 */
+		static constexpr unsigned SPIN_LIMIT = 64;
+
+		/**
+		 * @param  capacity Requested capacity
+		 * @return          Smallest power of two not less than the capacity
+		 */
+		static std::size_t roundCapacity(const std::size_t capacity)
+		{
+			std::size_t rounded = 2;
+			while (rounded < capacity)
+			{
+				rounded <<= 1;
+			}
+			return rounded;
+		}
+
+		void start()
+		{
+			writer = std::thread([this] { run(); });
+		}
+
+		/**
+		 * Claim a slot and copy a record into it.
+		 */
+		bool enqueue(const style & rendition,
+					 const char * text,
+					 const std::size_t length)
+		{
+			std::size_t position =
+				enqueuePosition.load(std::memory_order_relaxed);
+			slot * cell;
+			unsigned attempts = 0;
+			for (;;)
+			{
+				cell = &slots[position & mask];
+				const std::size_t sequence =
+					cell->sequence.load(std::memory_order_acquire);
+				if (sequence == position)
+				{
+					if (enqueuePosition.compare_exchange_weak(
+							position, position + 1, std::memory_order_relaxed))
+					{
+						break;
+					}
+				}
+				else if (sequence < position)
+				{
+					// Full: the slot still holds a record from the last lap
+					if (policy == DROP)
+					{
+						droppedCount.fetch_add(1, std::memory_order_relaxed);
+						return false;
+					}
+					notify();
+					if (++attempts < SPIN_LIMIT)
+					{
+						std::this_thread::yield();
+					}
+					else
+					{
+						waitForSlot(*cell, position);
+					}
+					position = enqueuePosition.load(std::memory_order_relaxed);
+				}
+				else
+				{
+					position = enqueuePosition.load(std::memory_order_relaxed);
+				}
+			}
+
+			cell->rendition = rendition;
+			cell->text.assign(text, length);
+			cell->sequence.store(position + 1, std::memory_order_release);
+
+			if (idle.load())
+			{
+				notify();
+			}
+			return true;
+		}
+
+		/**
+		 * Sleep until the background thread has freed a slot of the ring
+		 * buffer. A wakeup lost to a race is recovered by a bounded wait.
+		 *
+		 * @param cell     Slot found full
+		 * @param position Position at which the slot was found full
+		 */
+		void waitForSlot(const slot & cell, const std::size_t position)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			waitingProducers.fetch_add(1);
+			space.wait_for(lock, std::chrono::milliseconds(5), [&] {
+				return cell.sequence.load(std::memory_order_acquire) >=
+					   position;
+			});
+			waitingProducers.fetch_sub(1);
+		}
+
+		/**
+		 * Wake the background thread without taking its lock. A wakeup lost
+		 * to a race is recovered by the bounded wait in run().
+		 */
+		void notify() { wakeup.notify_one(); }
+
+		/**
+		 * Move ready records into the batch buffer, at most one ring buffer's
+		 * worth, so a batch stays bounded while producers keep up with the
+		 * background thread.
+		 *
+		 * @return True if any record was moved
+		 */
+		bool drain()
+		{
+			const std::size_t end = dequeuePosition + mask + 1;
+			while (dequeuePosition != end && ready())
+			{
+				slot & cell = slots[dequeuePosition & mask];
+				batch.append(sgr(cell.rendition), cell.text);
+				cell.sequence.store(dequeuePosition + mask + 1);
+				++dequeuePosition;
+				++batchRecords;
+			}
+
+			if (batchRecords == 0)
+			{
+				return false;
+			}
+			if (waitingProducers.load())
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				space.notify_all();
+			}
+			return true;
+		}
+
+		/**
+		 * Write the batch buffer to the output and clear it, counting its
+		 * records as failed if the write fails.
+		 */
+		void emit()
+		{
+			bool success = false;
+			switch (kind)
+			{
+			case FD_OUTPUT:
+				success = batch.writeTo(output.fd);
+				break;
+			case FILE_OUTPUT:
+				success = batch.writeTo(output.file) &&
+						  std::fflush(output.file) == 0;
+				break;
+			case STREAM_OUTPUT:
+				batch.writeTo(*output.stream);
+				success = !output.stream->flush().fail();
+				break;
+			}
+			if (!success)
+			{
+				failedCount.fetch_add(batchRecords, std::memory_order_relaxed);
+			}
+			batch.clear();
+			batchRecords = 0;
+			wroteAnything = true;
+		}
+
+		/**
+		 * Background thread body.
+		 */
+		void run()
+		{
+			for (;;)
+			{
+				const bool stop = stopping.load();
+				if (drain())
+				{
+					emit();
+				}
+
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					if (writtenPosition != dequeuePosition)
+					{
+						writtenPosition = dequeuePosition;
+						flushed.notify_all();
+					}
+					flushRequested = false;
+					if (stop && !ready())
+					{
+						break;
+					}
+					idle.store(true);
+					wakeup.wait_for(lock, std::chrono::milliseconds(5), [&] {
+						return stopping.load() || flushRequested || ready();
+					});
+					idle.store(false);
+				}
+			}
+
+			if (wroteAnything)
+			{
+				batch.append(static_sgr<sgr::RESET>::c_str(),
+							 static_sgr<sgr::RESET>::size());
+				emit();
+			}
+		}
+
+		/**
+		 * @return True if the next record is ready to be drained
+		 */
+		bool ready() const
+		{
+			return slots[dequeuePosition & mask].sequence.load(
+					   std::memory_order_acquire) == dequeuePosition + 1;
+		}
+
+		const OutputKind kind;
+		union
+		{
+			int fd;
+			std::FILE * file;
+			std::ostream * stream;
+		} output;
+
+		const OverflowPolicy policy;
+		const std::size_t mask;
+		std::unique_ptr<slot[]> slots;
+
+		alignas(64) std::atomic<std::size_t> enqueuePosition{0};
+		std::atomic<std::size_t> droppedCount{0};
+		std::atomic<std::size_t> waitingProducers{0};
+
+		alignas(64) std::size_t dequeuePosition = 0;
+		styled_buffer batch;
+		std::size_t batchRecords = 0;
+		bool wroteAnything = false;
+		std::atomic<std::size_t> failedCount{0};
+
+		std::mutex mutex;
+		std::condition_variable wakeup;
+		std::condition_variable space;
+		std::condition_variable flushed;
+		std::atomic<bool> idle{false};
+		std::atomic<bool> stopping{false};
+		bool flushRequested = false;
+		std::size_t writtenPosition = 0;
+
+		std::thread writer;
+	};
+CPP_SGR_END_NAMESPACE
+
+#endif /* end of include guard: CPP_SGR_ASYNC_SINK_HPP */
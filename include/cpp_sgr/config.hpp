@@ -0,0 +1,73 @@
+/**
+ *  cpp_sgr configuration shared by all headers.
+ *
+ *  @file config.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_CONFIG_HPP
+#define CPP_SGR_CONFIG_HPP
+
+/*
+  CPP_SGR_DISABLE changes what the inline functions and templates of the
+  library do, and must be defined consistently across a program. So that
+  translation units built with and without it never share a definition that
+  differs between them, which would violate the one definition rule, every
+  declaration lives in an inline namespace named after the configuration.
+  Translation units built differently then use distinct symbols, and passing
+  cpp_sgr objects between them fails to link instead of misbehaving.
+ */
+#ifdef CPP_SGR_DISABLE
+#define CPP_SGR_ABI_NAMESPACE disabled
+#else
+#define CPP_SGR_ABI_NAMESPACE enabled
+#endif
+
+/**
+ *  Library namespace.
+ *
+ *  @namespace cpp_sgr
+ */
+
+/**
+ * Open the library namespace and the inline namespace of the configuration.
+ */
+#define CPP_SGR_BEGIN_NAMESPACE                                                \
+	namespace cpp_sgr                                                          \
+	{                                                                          \
+		inline namespace CPP_SGR_ABI_NAMESPACE                                 \
+		{
+
+/**
+ * Close the namespaces opened by CPP_SGR_BEGIN_NAMESPACE.
+ */
+#define CPP_SGR_END_NAMESPACE                                                  \
+	}                                                                          \
+	}
+
+#endif /* end of include guard: CPP_SGR_CONFIG_HPP */
@@ -0,0 +1,2213 @@
+/**
+ *  cpp_sgr core: styles and their rendering, without iostream.
+ *
+ *  @file core.hpp
+ */
+
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_CORE_HPP
+#define CPP_SGR_CORE_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+/**
+ * Storage of the predefined sgr constants. They are constant-initialized in
+ * any case; with inline variables available, all translation units also
+ * share a single definition of each.
+ */
+#ifdef __cpp_inline_variables
+#define CPP_SGR_CONSTANT inline constexpr
+#else
+#define CPP_SGR_CONSTANT constexpr
+#endif
+
+CPP_SGR_BEGIN_NAMESPACE
+	/**
+	 * Implementation details; not part of the public interface.
+	 *
+	 * @namespace cpp_sgr::detail
+	 */
+	namespace detail
+	{
+		/**
+		 * Decimal representation of a value in the range [0,255], followed by
+		 * a parameter separator and padded so four bytes can always be copied.
+		 */
+		struct decimal_entry
+		{
+			char text[7];
+			std::uint8_t length; /**< Number of digits, excluding the ';' */
+		};
+
+		/**
+		 * Retrieve the table of decimal representations of [0,255].
+		 *
+		 * @return Pointer to the 256 table entries, indexed by value
+		 */
+		inline const decimal_entry * decimal_table() noexcept
+		{
+			static const decimal_entry table[256] = {
+				{"0;", 1}, {"1;", 1}, {"2;", 1}, {"3;", 1}, {"4;", 1},
+				{"5;", 1}, {"6;", 1}, {"7;", 1}, {"8;", 1}, {"9;", 1},
+				{"10;", 2}, {"11;", 2}, {"12;", 2}, {"13;", 2}, {"14;", 2},
+				{"15;", 2}, {"16;", 2}, {"17;", 2}, {"18;", 2}, {"19;", 2},
+				{"20;", 2}, {"21;", 2}, {"22;", 2}, {"23;", 2}, {"24;", 2},
+				{"25;", 2}, {"26;", 2}, {"27;", 2}, {"28;", 2}, {"29;", 2},
+				{"30;", 2}, {"31;", 2}, {"32;", 2}, {"33;", 2}, {"34;", 2},
+				{"35;", 2}, {"36;", 2}, {"37;", 2}, {"38;", 2}, {"39;", 2},
+				{"40;", 2}, {"41;", 2}, {"42;", 2}, {"43;", 2}, {"44;", 2},
+				{"45;", 2}, {"46;", 2}, {"47;", 2}, {"48;", 2}, {"49;", 2},
+				{"50;", 2}, {"51;", 2}, {"52;", 2}, {"53;", 2}, {"54;", 2},
+				{"55;", 2}, {"56;", 2}, {"57;", 2}, {"58;", 2}, {"59;", 2},
+				{"60;", 2}, {"61;", 2}, {"62;", 2}, {"63;", 2}, {"64;", 2},
+				{"65;", 2}, {"66;", 2}, {"67;", 2}, {"68;", 2}, {"69;", 2},
+				{"70;", 2}, {"71;", 2}, {"72;", 2}, {"73;", 2}, {"74;", 2},
+				{"75;", 2}, {"76;", 2}, {"77;", 2}, {"78;", 2}, {"79;", 2},
+				{"80;", 2}, {"81;", 2}, {"82;", 2}, {"83;", 2}, {"84;", 2},
+				{"85;", 2}, {"86;", 2}, {"87;", 2}, {"88;", 2}, {"89;", 2},
+				{"90;", 2}, {"91;", 2}, {"92;", 2}, {"93;", 2}, {"94;", 2},
+				{"95;", 2}, {"96;", 2}, {"97;", 2}, {"98;", 2}, {"99;", 2},
+				{"100;", 3}, {"101;", 3}, {"102;", 3}, {"103;", 3}, {"104;", 3},
+				{"105;", 3}, {"106;", 3}, {"107;", 3}, {"108;", 3}, {"109;", 3},
+				{"110;", 3}, {"111;", 3}, {"112;", 3}, {"113;", 3}, {"114;", 3},
+				{"115;", 3}, {"116;", 3}, {"117;", 3}, {"118;", 3}, {"119;", 3},
+				{"120;", 3}, {"121;", 3}, {"122;", 3}, {"123;", 3}, {"124;", 3},
+				{"125;", 3}, {"126;", 3}, {"127;", 3}, {"128;", 3}, {"129;", 3},
+				{"130;", 3}, {"131;", 3}, {"132;", 3}, {"133;", 3}, {"134;", 3},
+				{"135;", 3}, {"136;", 3}, {"137;", 3}, {"138;", 3}, {"139;", 3},
+				{"140;", 3}, {"141;", 3}, {"142;", 3}, {"143;", 3}, {"144;", 3},
+				{"145;", 3}, {"146;", 3}, {"147;", 3}, {"148;", 3}, {"149;", 3},
+				{"150;", 3}, {"151;", 3}, {"152;", 3}, {"153;", 3}, {"154;", 3},
+				{"155;", 3}, {"156;", 3}, {"157;", 3}, {"158;", 3}, {"159;", 3},
+				{"160;", 3}, {"161;", 3}, {"162;", 3}, {"163;", 3}, {"164;", 3},
+				{"165;", 3}, {"166;", 3}, {"167;", 3}, {"168;", 3}, {"169;", 3},
+				{"170;", 3}, {"171;", 3}, {"172;", 3}, {"173;", 3}, {"174;", 3},
+				{"175;", 3}, {"176;", 3}, {"177;", 3}, {"178;", 3}, {"179;", 3},
+				{"180;", 3}, {"181;", 3}, {"182;", 3}, {"183;", 3}, {"184;", 3},
+				{"185;", 3}, {"186;", 3}, {"187;", 3}, {"188;", 3}, {"189;", 3},
+				{"190;", 3}, {"191;", 3}, {"192;", 3}, {"193;", 3}, {"194;", 3},
+				{"195;", 3}, {"196;", 3}, {"197;", 3}, {"198;", 3}, {"199;", 3},
+				{"200;", 3}, {"201;", 3}, {"202;", 3}, {"203;", 3}, {"204;", 3},
+				{"205;", 3}, {"206;", 3}, {"207;", 3}, {"208;", 3}, {"209;", 3},
+				{"210;", 3}, {"211;", 3}, {"212;", 3}, {"213;", 3}, {"214;", 3},
+				{"215;", 3}, {"216;", 3}, {"217;", 3}, {"218;", 3}, {"219;", 3},
+				{"220;", 3}, {"221;", 3}, {"222;", 3}, {"223;", 3}, {"224;", 3},
+				{"225;", 3}, {"226;", 3}, {"227;", 3}, {"228;", 3}, {"229;", 3},
+				{"230;", 3}, {"231;", 3}, {"232;", 3}, {"233;", 3}, {"234;", 3},
+				{"235;", 3}, {"236;", 3}, {"237;", 3}, {"238;", 3}, {"239;", 3},
+				{"240;", 3}, {"241;", 3}, {"242;", 3}, {"243;", 3}, {"244;", 3},
+				{"245;", 3}, {"246;", 3}, {"247;", 3}, {"248;", 3}, {"249;", 3},
+				{"250;", 3}, {"251;", 3}, {"252;", 3}, {"253;", 3}, {"254;", 3},
+				{"255;", 3}
+			};
+			return table;
+		}
+
+		/**
+		 * Write the decimal representation of a value in the range [0,255].
+		 *
+		 * @param  out   Buffer to write into
+		 * @param  value Value to write
+		 * @return       Pointer past the last character written
+		 */
+		inline char * write_decimal(char * out, const unsigned value) noexcept
+		{
+			const decimal_entry & entry = decimal_table()[value];
+			out[0] = entry.text[0];
+			if (entry.length > 1)
+			{
+				out[1] = entry.text[1];
+				if (entry.length > 2)
+				{
+					out[2] = entry.text[2];
+				}
+			}
+			return out + entry.length;
+		}
+
+		/**
+		 * Write the decimal representation of a value in the range [0,255]
+		 * followed by a ';' separator, as a single four byte store.
+		 *
+		 * Up to four bytes are written regardless of the length of the value,
+		 * so the buffer must extend at least four bytes past out.
+		 *
+		 * @param  out   Buffer to write into
+		 * @param  value Value to write
+		 * @return       Pointer past the separator
+		 */
+		inline char * write_decimal_param(char * out,
+										  const unsigned value) noexcept
+		{
+			const decimal_entry & entry = decimal_table()[value];
+			std::memcpy(out, entry.text, 4);
+			return out + entry.length + 1;
+		}
+
+		/**
+		 * Compute the length of the decimal representation of a value in the
+		 * range [0,255].
+		 *
+		 * @param  value Value to measure
+		 * @return       Number of decimal digits
+		 */
+		constexpr std::size_t decimal_length(const unsigned value) noexcept
+		{
+			return value >= 100 ? 3 : (value >= 10 ? 2 : 1);
+		}
+	}   // namespace detail
+
+	/**
+	 * 24-bit color, given as its three 8-bit components.
+	 */
+	struct rgb
+	{
+		std::uint8_t r; /**< Red component */
+		std::uint8_t g; /**< Green component */
+		std::uint8_t b; /**< Blue component */
+	};
+
+	/**
+	 * Number of colors a terminal can display. Colors beyond a terminal's
+	 * depth are replaced by the nearest color it supports.
+	 */
+	enum ColorDepth
+	{
+		TRUECOLOR = 0,   /**< 24-bit colors */
+		INDEXED_256 = 1, /**< xterm 256 color palette */
+		ANSI_16 = 2,     /**< 3/4-bit colors */
+		MONOCHROME = 3,  /**< No colors at all */
+		PLAIN = 4        /**< No escape sequences at all */
+	};
+
+	class rendered_style;
+
+	/**
+	 * Compact value representation of a combination of SGRs.
+	 *
+	 * @class style
+	 * Holds a bitmask of the non-color SGR codes in effect, plus packed
+	 * foreground and background color slots. Each slot is either empty or
+	 * holds a 3/4-bit, 8-bit indexed or 24-bit color. A style is trivially
+	 * copyable, hashable and comparable, and is only converted into an escape
+	 * sequence when rendered.
+	 */
+	class style
+	{
+	public:
+		/**
+		 * Kinds of color held by a color slot.
+		 */
+		enum ColorKind
+		{
+			NO_COLOR = 0,
+			ANSI_COLOR = 1,
+			INDEXED_COLOR = 2,
+			RGB_COLOR = 3
+		};
+
+		enum : std::size_t
+		{
+			/**
+			 * Maximum length of the escape sequence of any style.
+			 */
+			MAX_RENDERED_SIZE = 65,
+
+			/**
+			 * Maximum length of the escape sequence written by
+			 * writeTransition().
+			 */
+			MAX_TRANSITION_SIZE = MAX_RENDERED_SIZE + 2,
+
+			/**
+			 * Buffer size required by writeRGB(). The longest parameters
+			 * written are 16 bytes, but one more may be overwritten.
+			 */
+			RGB_PARAMS_CAPACITY = 17,
+
+			/**
+			 * Buffer size required per color by writeRGBSequences(), equal to
+			 * the length of the longest sequence written.
+			 */
+			RGB_SEQUENCE_CAPACITY = 19
+		};
+
+		/**
+		 * Construct an empty style, which applies no SGRs.
+		 */
+		constexpr style() noexcept : attributes(0), foreground(0), background(0)
+		{}
+
+		/**
+		 * Construct a style from its packed representation.
+		 *
+		 * @param attributes Bitmask of SGR codes, see attributeBit()
+		 * @param foreground Packed foreground color slot
+		 * @param background Packed background color slot
+		 */
+		constexpr style(const std::uint16_t attributes,
+						const std::uint32_t foreground,
+						const std::uint32_t background) noexcept :
+			attributes(attributes),
+			foreground(foreground), background(background)
+		{}
+
+		/**
+		 * Construct a style applying a single non-color SGR code.
+		 *
+		 * @param  code Non-color SGR code, e.g. sgr::BOLD
+		 * @return      style applying the given code
+		 */
+		static constexpr style fromCode(const int code) noexcept
+		{
+			return style(attributeBit(code), 0, 0);
+		}
+
+		/**
+		 * Retrieve the attribute bit corresponding to a non-color SGR code.
+		 *
+		 * @param  code Non-color SGR code, e.g. sgr::BOLD
+		 * @return      Attribute bit, or 0 if the code is not supported
+		 */
+		static constexpr std::uint16_t attributeBit(const int code) noexcept
+		{
+			return static_cast<std::uint16_t>(
+				code >= 0 && code <= 9
+					? 1u << code
+					: (code >= 51 && code <= 53 ? 1u << (code - 41) : 0u));
+		}
+
+		/**
+		 * Pack a 3/4-bit color into a color slot.
+		 *
+		 * @param  code Foreground form of the color code, e.g. color::RED
+		 * @return      Packed color slot
+		 */
+		static constexpr std::uint32_t ansiColor(const int code) noexcept
+		{
+			return std::uint32_t(ANSI_COLOR) << 24 | std::uint32_t(code);
+		}
+
+		/**
+		 * Pack an 8-bit indexed color into a color slot.
+		 *
+		 * @param  index Color index in the range [0,255]
+		 * @return       Packed color slot
+		 */
+		static constexpr std::uint32_t indexedColor(const int index) noexcept
+		{
+			return std::uint32_t(INDEXED_COLOR) << 24 | std::uint32_t(index);
+		}
+
+		/**
+		 * Pack a 24-bit color into a color slot.
+		 *
+		 * @param  r 8-bit red component
+		 * @param  g 8-bit green component
+		 * @param  b 8-bit blue component
+		 * @return   Packed color slot
+		 */
+		static constexpr std::uint32_t rgbColor(const int r,
+												const int g,
+												const int b) noexcept
+		{
+			return std::uint32_t(RGB_COLOR) << 24 | std::uint32_t(r) << 16 |
+				   std::uint32_t(g) << 8 | std::uint32_t(b);
+		}
+
+		/**
+		 * Retrieve the kind of color held by a packed color slot.
+		 *
+		 * @param  slot Packed color slot
+		 * @return      Kind of color held by the slot
+		 */
+		static constexpr ColorKind colorKind(const std::uint32_t slot) noexcept
+		{
+			return static_cast<ColorKind>(slot >> 24);
+		}
+
+		/**
+		 * Pack a 24-bit color into a color slot.
+		 *
+		 * @param  value 24-bit color
+		 * @return       Packed color slot
+		 */
+		static constexpr std::uint32_t rgbColor(const rgb & value) noexcept
+		{
+			return rgbColor(value.r, value.g, value.b);
+		}
+
+		/**
+		 * Write the SGR parameters setting a 24-bit color, e.g.
+		 * "38;2;255;128;0", using one table lookup and store per component.
+		 *
+		 * @param  out        Buffer of at least RGB_PARAMS_CAPACITY bytes
+		 * @param  value      24-bit color
+		 * @param  foreground True for a foreground color, else background
+		 * @return            Pointer past the last character written
+		 */
+		static char * writeRGB(char * out,
+							   const rgb & value,
+							   const bool foreground) noexcept
+		{
+			std::memcpy(out, foreground ? "38;2;" : "48;2;", 5);
+			out = detail::write_decimal_param(out + 5, value.r);
+			out = detail::write_decimal_param(out, value.g);
+			return detail::write_decimal_param(out, value.b) - 1;
+		}
+
+		/**
+		 * Write one complete escape sequence per 24-bit color, e.g.
+		 * "\033[38;2;255;128;0m", back to back.
+		 *
+		 * @param  out        Buffer of at least count * RGB_SEQUENCE_CAPACITY
+		 *                    bytes
+		 * @param  values     Colors to encode
+		 * @param  count      Number of colors
+		 * @param  foreground True for foreground colors, else background
+		 * @param  ends       If not null, receives for each color the offset
+		 *                    from out past the end of its sequence
+		 * @return            Pointer past the last character written
+		 */
+		static char * writeRGBSequences(char * out,
+										const rgb * values,
+										const std::size_t count,
+										const bool foreground,
+										std::size_t * ends = nullptr) noexcept
+		{
+			char * const start = out;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				out[0] = '\033';
+				out[1] = '[';
+				out = writeRGB(out + 2, values[i], foreground);
+				*out++ = 'm';
+				if (ends)
+				{
+					ends[i] = static_cast<std::size_t>(out - start);
+				}
+			}
+			return out;
+		}
+
+		/**
+		 * Check whether this style applies the given non-color SGR code.
+		 *
+		 * @param  code Non-color SGR code, e.g. sgr::BOLD
+		 * @return      True if the code is applied, else false
+		 */
+		constexpr bool has(const int code) const noexcept
+		{
+			return (attributes & attributeBit(code)) != 0;
+		}
+
+		/**
+		 * Check whether this style applies no SGRs at all.
+		 *
+		 * @return True if empty, else false
+		 */
+		constexpr bool empty() const noexcept
+		{
+			return attributes == 0 && foreground == 0 && background == 0;
+		}
+
+		/**
+		 * @return Bitmask of the non-color SGR codes applied by this style
+		 */
+		constexpr std::uint16_t attributeMask() const noexcept
+		{
+			return attributes;
+		}
+
+		/**
+		 * @return Packed foreground color slot
+		 */
+		constexpr std::uint32_t foregroundColor() const noexcept
+		{
+			return foreground;
+		}
+
+		/**
+		 * @return Packed background color slot
+		 */
+		constexpr std::uint32_t backgroundColor() const noexcept
+		{
+			return background;
+		}
+
+		/**
+		 * Combine this style with another style applied after it.
+		 *
+		 * Attributes accumulate and colors of the right style replace those of
+		 * this style, which matches how a terminal processes the two escape
+		 * sequences in order. If the right style resets, nothing of this
+		 * style survives.
+		 *
+		 * @param  right style applied after this one
+		 * @return       Combined style
+		 */
+		constexpr style merge(const style & right) const noexcept
+		{
+			return right.has(0)
+					   ? right
+					   : style(static_cast<std::uint16_t>(attributes |
+														  right.attributes),
+							   right.foreground ? right.foreground : foreground,
+							   right.background ? right.background
+												: background);
+		}
+
+		/**
+		 * Retrieve the rendition in effect after applying this style to the
+		 * default rendition, i.e. this style without its reset.
+		 *
+		 * @return style without the reset code
+		 */
+		constexpr style effective() const noexcept
+		{
+			return style(static_cast<std::uint16_t>(attributes & ~1u),
+						 foreground,
+						 background);
+		}
+
+		/**
+		 * Replace colors this style uses beyond a color depth with the
+		 * perceptually nearest colors within it. Each replacement costs a
+		 * single table lookup. For PLAIN, the result is the empty style.
+		 *
+		 * @param  depth Color depth to fit the colors into
+		 * @return       style using only colors within the given depth
+		 */
+		style quantized(ColorDepth depth) const noexcept;
+
+		/**
+		 * Apply a single SGR parameter to this rendition, the way a terminal
+		 * would. Unlike merge(), this understands the codes turning
+		 * individual attributes and colors off (22-29, 39, 49, 54, 55).
+		 * Unsupported codes and the multi-parameter colors 38 and 48 leave the
+		 * rendition unchanged; see applyParams() for the latter.
+		 *
+		 * @param  code SGR parameter
+		 * @return      Resulting rendition
+		 */
+		style applyCode(const int code) const noexcept
+		{
+			if (code == 0)
+			{
+				return style();
+			}
+			if ((code >= 30 && code <= 37) || (code >= 90 && code <= 97))
+			{
+				return style(attributes, ansiColor(code), background);
+			}
+			if ((code >= 40 && code <= 47) || (code >= 100 && code <= 107))
+			{
+				return style(attributes, foreground, ansiColor(code - 10));
+			}
+
+			switch (code)
+			{
+			case 22:
+				return withoutAttributes(attributeBit(1) | attributeBit(2));
+			case 23:
+			case 24:
+			case 27:
+			case 28:
+			case 29:
+				return withoutAttributes(attributeBit(code - 20));
+			case 25:
+				return withoutAttributes(attributeBit(5) | attributeBit(6));
+			case 39:
+				return style(attributes, 0, background);
+			case 49:
+				return style(attributes, foreground, 0);
+			case 54:
+				return withoutAttributes(attributeBit(51) | attributeBit(52));
+			case 55:
+				return withoutAttributes(attributeBit(53));
+			default:
+				return style(static_cast<std::uint16_t>(attributes |
+														attributeBit(code)),
+							 foreground,
+							 background);
+			}
+		}
+
+		/**
+		 * Apply a complete list of SGR parameters, as found between the
+		 * escape and terminator of an escape sequence, to this rendition.
+		 * An empty list resets, as it does on a terminal.
+		 *
+		 * @param  params SGR parameters
+		 * @param  count  Number of parameters
+		 * @return        Resulting rendition
+		 */
+		style applyParams(const int * params, const std::size_t count) const
+			noexcept
+		{
+			if (count == 0)
+			{
+				return style();
+			}
+
+			style result = *this;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const int code = params[i];
+				if ((code == 38 || code == 48) && i + 2 < count &&
+					params[i + 1] == 5)
+				{
+					if (isComponent(params[i + 2]))
+					{
+						result = result.withColor(code == 38,
+												  indexedColor(params[i + 2]));
+					}
+					i += 2;
+				}
+				else if ((code == 38 || code == 48) && i + 4 < count &&
+						 params[i + 1] == 2)
+				{
+					const int r = params[i + 2];
+					const int g = params[i + 3];
+					const int b = params[i + 4];
+					if (isComponent(r) && isComponent(g) && isComponent(b))
+					{
+						result = result.withColor(code == 38, rgbColor(r, g, b));
+					}
+					i += 4;
+				}
+				else
+				{
+					result = result.applyCode(code);
+				}
+			}
+			return result;
+		}
+
+		/**
+		 * Write the shortest escape sequence changing the rendition of a
+		 * terminal from one style to another.
+		 *
+		 * Attributes and colors no longer in effect are either turned off
+		 * individually or by resetting and reapplying the target style,
+		 * whichever is shorter. Nothing is written if the styles are equal.
+		 * The buffer must have room for MAX_TRANSITION_SIZE bytes.
+		 *
+		 * @param  from Rendition currently in effect
+		 * @param  to   Rendition to change to
+		 * @param  out  Buffer to write into
+		 * @return      Pointer past the last character written
+		 */
+		static char * writeTransition(const style & from,
+									  const style & to,
+									  char * out) noexcept
+		{
+			const style current = from.effective();
+			const style target = to.effective();
+			if (current == target)
+			{
+				return out;
+			}
+
+			// Codes turning attributes off, with the attributes they affect
+			static const struct
+			{
+				unsigned code;
+				std::uint16_t mask;
+			} offCodes[] = {
+				{22, attributeBit(1) | attributeBit(2)},
+				{23, attributeBit(3)},
+				{24, attributeBit(4)},
+				{25, attributeBit(5) | attributeBit(6)},
+				{27, attributeBit(7)},
+				{28, attributeBit(8)},
+				{29, attributeBit(9)},
+				{54, attributeBit(51) | attributeBit(52)},
+				{55, attributeBit(53)},
+			};
+
+			char scratch[128];
+			char * params = scratch + 2;
+			char * p = params;
+
+			const unsigned removed = current.attributes & ~target.attributes;
+			unsigned cleared = 0;
+			for (const auto & off : offCodes)
+			{
+				if (removed & off.mask)
+				{
+					if (p != params)
+					{
+						*p++ = ';';
+					}
+					p = detail::write_decimal(p, off.code);
+					cleared |= off.mask;
+				}
+			}
+
+			const style added(
+				static_cast<std::uint16_t>(target.attributes &
+										   (~current.attributes | cleared)),
+				0,
+				0);
+			if (!added.empty())
+			{
+				if (p != params)
+				{
+					*p++ = ';';
+				}
+				p = added.writeParams(p);
+			}
+
+			p = writeColorChange(p, current.foreground, target.foreground, 0,
+								 p != params);
+			p = writeColorChange(p, current.background, target.background, 10,
+								 p != params);
+
+			const std::size_t resetSize =
+				target.empty() ? 4 : target.renderedSize() + 2;
+			if (static_cast<std::size_t>(p - params) + 3 < resetSize)
+			{
+				*out++ = '\033';
+				*out++ = '[';
+				for (char * c = params; c != p; ++c)
+				{
+					*out++ = *c;
+				}
+				*out++ = 'm';
+				return out;
+			}
+
+			*out++ = '\033';
+			*out++ = '[';
+			*out++ = '0';
+			if (!target.empty())
+			{
+				*out++ = ';';
+				out = target.writeParams(out);
+			}
+			*out++ = 'm';
+			return out;
+		}
+
+		/**
+		 * Compute a hash of this style.
+		 *
+		 * @return Hash value
+		 */
+		std::size_t hash() const noexcept
+		{
+			std::uint64_t h = (std::uint64_t(foreground) << 32 | background) ^
+							  std::uint64_t(attributes) * 0x9E3779B97F4A7C15u;
+			h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9u;
+			h = (h ^ (h >> 27)) * 0x94D049BB133111EBu;
+			return static_cast<std::size_t>(h ^ (h >> 31));
+		}
+
+		/**
+		 * Retrieve the escape sequence string represented by this style.
+		 *
+		 * @return std::string representing this style; empty if the style
+		 * applies no SGRs
+		 */
+		std::string toString() const
+		{
+			char buffer[MAX_RENDERED_SIZE];
+			return std::string(buffer, writeTo(buffer));
+		}
+
+		/**
+		 * Compute the exact length of the escape sequence of this style.
+		 *
+		 * @return Number of bytes written by writeTo()
+		 */
+		std::size_t renderedSize() const noexcept
+		{
+			std::size_t params = 0;
+			std::size_t size = 0;
+			for (unsigned bit = 0; bit < 13; ++bit)
+			{
+				if (attributes & (1u << bit))
+				{
+					++params;
+					size += bit <= 9 ? 1 : 2;
+				}
+			}
+			if (foreground)
+			{
+				++params;
+				size += colorSize(foreground, 0);
+			}
+			if (background)
+			{
+				++params;
+				size += colorSize(background, 10);
+			}
+			return params == 0 ? 0 : size + (params - 1) + 3;
+		}
+
+		/**
+		 * Write the escape sequence of this style into a buffer.
+		 *
+		 * The buffer must have room for at least renderedSize() bytes;
+		 * MAX_RENDERED_SIZE bytes always suffice. No null terminator is
+		 * written, and nothing is written if the style is empty.
+		 *
+		 * @param  out Buffer to write into
+		 * @return     Pointer past the last character written
+		 */
+		char * writeTo(char * out) const noexcept
+		{
+			if (empty())
+			{
+				return out;
+			}
+
+			*out++ = '\033';
+			*out++ = '[';
+			out = writeParams(out);
+			*out++ = 'm';
+			return out;
+		}
+
+		/**
+		 * Append the escape sequence of this style to a std::string. Does not
+		 * allocate if the string has sufficient capacity.
+		 *
+		 * @param out std::string to append to
+		 */
+		void appendTo(std::string & out) const
+		{
+			char buffer[MAX_RENDERED_SIZE];
+			out.append(buffer, writeTo(buffer));
+		}
+
+		/**
+		 * Render the escape sequence of this style into an inline buffer.
+		 *
+		 * @return Rendered escape sequence
+		 */
+		rendered_style render() const noexcept;
+
+		friend constexpr bool operator==(const style & left,
+										 const style & right) noexcept
+		{
+			return left.attributes == right.attributes &&
+				   left.foreground == right.foreground &&
+				   left.background == right.background;
+		}
+
+		friend constexpr bool operator!=(const style & left,
+										 const style & right) noexcept
+		{
+			return !(left == right);
+		}
+
+	private:
+		/**
+		 * @param  value Parameter of an 8-bit or 24-bit color
+		 * @return       True if the value is in the range [0,255]
+		 */
+		static constexpr bool isComponent(const int value) noexcept
+		{
+			return value >= 0 && value <= 255;
+		}
+
+		/**
+		 * Remove attributes from this style.
+		 *
+		 * @param  mask Bitmask of attributes to remove
+		 * @return      Resulting style
+		 */
+		constexpr style withoutAttributes(const unsigned mask) const noexcept
+		{
+			return style(static_cast<std::uint16_t>(attributes & ~mask),
+						 foreground,
+						 background);
+		}
+
+		/**
+		 * Replace a color slot of this style.
+		 *
+		 * @param  isForeground True to replace the foreground, else the
+		 * background
+		 * @param  slot         Packed color slot
+		 * @return              Resulting style
+		 */
+		constexpr style withColor(const bool isForeground,
+								  const std::uint32_t slot) const noexcept
+		{
+			return isForeground ? style(attributes, slot, background)
+								: style(attributes, foreground, slot);
+		}
+
+		/**
+		 * Write the SGR parameters changing a color slot, if it changed.
+		 *
+		 * @param  out      Buffer to write into
+		 * @param  from     Packed color slot currently in effect
+		 * @param  to       Packed color slot to change to
+		 * @param  offset   0 for a foreground color, 10 for a background color
+		 * @param  separate True if a separator must precede the parameters
+		 * @return          Pointer past the last character written
+		 */
+		static char * writeColorChange(char * out,
+									   const std::uint32_t from,
+									   const std::uint32_t to,
+									   const unsigned offset,
+									   const bool separate) noexcept
+		{
+			if (from == to)
+			{
+				return out;
+			}
+			if (to)
+			{
+				return writeColor(out, to, offset, separate);
+			}
+			if (separate)
+			{
+				*out++ = ';';
+			}
+			return detail::write_decimal(out, 39 + offset);
+		}
+
+		/**
+		 * Compute the length of the SGR parameters of a packed color slot.
+		 *
+		 * @param  slot   Packed color slot
+		 * @param  offset 0 for a foreground color, 10 for a background color
+		 * @return        Length of the parameters in bytes
+		 */
+		static std::size_t colorSize(const std::uint32_t slot,
+									 const unsigned offset) noexcept
+		{
+			switch (colorKind(slot))
+			{
+			case ANSI_COLOR:
+				return detail::decimal_length((slot & 0xFF) + offset);
+			case INDEXED_COLOR:
+				return 5 + detail::decimal_length(slot & 0xFF);
+			case RGB_COLOR:
+				return 7 + detail::decimal_length(slot >> 16 & 0xFF) +
+					   detail::decimal_length(slot >> 8 & 0xFF) +
+					   detail::decimal_length(slot & 0xFF);
+			default:
+				return 0;
+			}
+		}
+
+		/**
+		 * Write the semicolon-separated SGR parameters of this style.
+		 *
+		 * @param  out Buffer to write into
+		 * @return     Pointer past the last character written
+		 */
+		char * writeParams(char * out) const noexcept
+		{
+			char * const start = out;
+			for (unsigned bit = 0; bit < 13; ++bit)
+			{
+				if (attributes & (1u << bit))
+				{
+					if (out != start)
+					{
+						*out++ = ';';
+					}
+					out = detail::write_decimal(out, bit <= 9 ? bit : bit + 41);
+				}
+			}
+			out = writeColor(out, foreground, 0, out != start);
+			return writeColor(out, background, 10, out != start);
+		}
+
+		/**
+		 * Write the SGR parameters of a packed color slot.
+		 *
+		 * @param  out       Buffer to write into
+		 * @param  slot      Packed color slot
+		 * @param  offset    0 for a foreground color, 10 for a background color
+		 * @param  separate  True if a separator must precede the parameters
+		 * @return           Pointer past the last character written
+		 */
+		static char * writeColor(char * out,
+								 const std::uint32_t slot,
+								 const unsigned offset,
+								 const bool separate) noexcept
+		{
+			const ColorKind kind = colorKind(slot);
+			if (kind == NO_COLOR)
+			{
+				return out;
+			}
+			if (separate)
+			{
+				*out++ = ';';
+			}
+			if (kind == ANSI_COLOR)
+			{
+				return detail::write_decimal(out, (slot & 0xFF) + offset);
+			}
+
+			out = detail::write_decimal(out, 38 + offset);
+			*out++ = ';';
+			if (kind == INDEXED_COLOR)
+			{
+				*out++ = '5';
+				*out++ = ';';
+				return detail::write_decimal(out, slot & 0xFF);
+			}
+			*out++ = '2';
+			*out++ = ';';
+			// Parameters are always followed by at least one more byte, which
+			// covers the padding write_decimal_param() may store past blue
+			out = detail::write_decimal_param(out, slot >> 16 & 0xFF);
+			out = detail::write_decimal_param(out, slot >> 8 & 0xFF);
+			return detail::write_decimal(out, slot & 0xFF);
+		}
+
+		std::uint16_t attributes;
+		std::uint32_t foreground;
+		std::uint32_t background;
+	};
+
+	/**
+	 * Escape sequence of a style, rendered into an inline buffer.
+	 *
+	 * @class rendered_style
+	 * Gives std::string_view-like access to the rendered bytes without any
+	 * heap allocation.
+	 */
+	class rendered_style
+	{
+	public:
+		/**
+		 * Render the escape sequence of the given style.
+		 *
+		 * @param s style to render
+		 */
+		explicit rendered_style(const style & s) noexcept :
+			length(static_cast<std::uint8_t>(s.writeTo(buffer) - buffer))
+		{}
+
+		/**
+		 * @return Pointer to the first byte of the escape sequence
+		 */
+		const char * data() const noexcept { return buffer; }
+
+		/**
+		 * @return Length of the escape sequence in bytes
+		 */
+		std::size_t size() const noexcept { return length; }
+
+		/**
+		 * @return True if the escape sequence is empty, else false
+		 */
+		bool empty() const noexcept { return length == 0; }
+
+		const char * begin() const noexcept { return buffer; }
+		const char * end() const noexcept { return buffer + length; }
+
+#if __cplusplus >= 201703L
+		/**
+		 * @return View of the escape sequence
+		 */
+		operator std::string_view() const noexcept
+		{
+			return std::string_view(buffer, length);
+		}
+#endif
+
+	private:
+		char buffer[style::MAX_RENDERED_SIZE];
+		std::uint8_t length;
+	};
+
+	inline rendered_style style::render() const noexcept
+	{
+		return rendered_style(*this);
+	}
+
+	namespace detail
+	{
+		/**
+		 * Retrieve the color of an entry of the xterm 256 color palette. The
+		 * first 16 entries use xterm's default 3/4-bit colors.
+		 *
+		 * @param  index Palette index in the range [0,255]
+		 * @return       24-bit color of the palette entry
+		 */
+		inline rgb indexed_rgb(const unsigned index) noexcept
+		{
+			static const rgb system[16] = {
+				{0, 0, 0},       {205, 0, 0},     {0, 205, 0},
+				{205, 205, 0},   {0, 0, 238},     {205, 0, 205},
+				{0, 205, 205},   {229, 229, 229}, {127, 127, 127},
+				{255, 0, 0},     {0, 255, 0},     {255, 255, 0},
+				{92, 92, 255},   {255, 0, 255},   {0, 255, 255},
+				{255, 255, 255}};
+			static const std::uint8_t levels[6] = {0, 95, 135, 175, 215, 255};
+
+			if (index < 16)
+			{
+				return system[index];
+			}
+			if (index >= 232)
+			{
+				const std::uint8_t gray =
+					static_cast<std::uint8_t>(8 + 10 * (index - 232));
+				return rgb{gray, gray, gray};
+			}
+			const unsigned cube = index - 16;
+			return rgb{levels[cube / 36], levels[cube / 6 % 6],
+					   levels[cube % 6]};
+		}
+
+		/**
+		 * Compute the perceptual distance between two colors, using the
+		 * "redmean" weighted Euclidean metric.
+		 *
+		 * @param  a First color
+		 * @param  b Second color
+		 * @return   Squared weighted distance
+		 */
+		inline unsigned color_distance(const rgb & a, const rgb & b) noexcept
+		{
+			const int mean = (a.r + b.r) / 2;
+			const int dr = a.r - b.r;
+			const int dg = a.g - b.g;
+			const int db = a.b - b.b;
+			return static_cast<unsigned>((((512 + mean) * dr * dr) >> 8) +
+										 4 * dg * dg +
+										 (((767 - mean) * db * db) >> 8));
+		}
+
+		/**
+		 * Convert a palette index in [0,15] into its 3/4-bit color code.
+		 *
+		 * @param  index Palette index
+		 * @return       Foreground color code, e.g. 31 or 91
+		 */
+		constexpr unsigned ansi_code(const unsigned index) noexcept
+		{
+			return index < 8 ? 30 + index : 82 + index;
+		}
+
+		/**
+		 * Nearest palette colors of every cell of a 32x32x32 grid over the
+		 * 24-bit color space, i.e. of each color with its components
+		 * truncated to 5 bits.
+		 */
+		struct quantization_table
+		{
+			enum : std::size_t
+			{
+				CELLS = 1 << 15 /**< Number of cells in the grid */
+			};
+
+			/**
+			 * Build the table with a nearest-neighbour search per cell.
+			 */
+			quantization_table() noexcept
+			{
+				rgb palette[256];
+				for (unsigned i = 0; i < 256; ++i)
+				{
+					palette[i] = indexed_rgb(i);
+				}
+
+				for (unsigned cell = 0; cell < CELLS; ++cell)
+				{
+					const rgb center = cellColor(cell);
+					// The first 16 palette entries vary between terminals,
+					// so 256 color output only picks from the others
+					indexed[cell] = nearest(palette, 16, 256, center);
+					ansi[cell] = nearest(palette, 0, 16, center);
+				}
+				for (unsigned i = 0; i < 256; ++i)
+				{
+					indexedAnsi[i] = i < 16 ? static_cast<std::uint8_t>(i)
+											: ansi[cellOf(palette[i])];
+				}
+			}
+
+			/**
+			 * @param  value 24-bit color
+			 * @return       Index of the grid cell holding the color
+			 */
+			static unsigned cellOf(const rgb & value) noexcept
+			{
+				return unsigned(value.r >> 3) << 10 |
+					   unsigned(value.g >> 3) << 5 | unsigned(value.b >> 3);
+			}
+
+			std::uint8_t indexed[CELLS]; /**< Nearest index in [16,255] */
+			std::uint8_t ansi[CELLS];    /**< Nearest index in [0,15] */
+			std::uint8_t indexedAnsi[256]; /**< Palette index to [0,15] */
+
+		private:
+			/**
+			 * @param  cell Index of a grid cell
+			 * @return      Color at the center of the cell, stretched so
+			 *              the outermost cells hold 0 and 255
+			 */
+			static rgb cellColor(const unsigned cell) noexcept
+			{
+				const unsigned r = cell >> 10;
+				const unsigned g = cell >> 5 & 31;
+				const unsigned b = cell & 31;
+				return rgb{static_cast<std::uint8_t>(r << 3 | r >> 2),
+						   static_cast<std::uint8_t>(g << 3 | g >> 2),
+						   static_cast<std::uint8_t>(b << 3 | b >> 2)};
+			}
+
+			/**
+			 * @param  palette Palette colors
+			 * @param  first   First palette index to consider
+			 * @param  last    Palette index past the last one to consider
+			 * @param  value   Color to match
+			 * @return         Index of the nearest palette color
+			 */
+			static std::uint8_t nearest(const rgb * palette,
+										const unsigned first,
+										const unsigned last,
+										const rgb & value) noexcept
+			{
+				unsigned best = first;
+				unsigned bestDistance = ~0u;
+				for (unsigned i = first; i < last; ++i)
+				{
+					const unsigned distance = color_distance(palette[i], value);
+					if (distance < bestDistance)
+					{
+						best = i;
+						bestDistance = distance;
+					}
+				}
+				return static_cast<std::uint8_t>(best);
+			}
+		};
+
+		/**
+		 * @return Quantization table, built on first use
+		 */
+		inline const quantization_table & quantization()
+		{
+			static const quantization_table table;
+			return table;
+		}
+
+		/**
+		 * Replace the color of a packed color slot with the nearest color
+		 * within a color depth.
+		 *
+		 * @param  slot  Packed color slot
+		 * @param  depth Color depth to fit the color into
+		 * @return       Packed color slot within the given depth
+		 */
+		inline std::uint32_t quantize_slot(const std::uint32_t slot,
+										   const ColorDepth depth) noexcept
+		{
+			if (depth == MONOCHROME || depth == PLAIN)
+			{
+				return 0;
+			}
+
+			const style::ColorKind kind = style::colorKind(slot);
+			if (depth == TRUECOLOR || kind == style::NO_COLOR ||
+				kind == style::ANSI_COLOR ||
+				(depth == INDEXED_256 && kind == style::INDEXED_COLOR))
+			{
+				return slot;
+			}
+
+			const quantization_table & table = quantization();
+			if (kind == style::INDEXED_COLOR)
+			{
+				const unsigned index = table.indexedAnsi[slot & 0xFF];
+				return style::ansiColor(static_cast<int>(ansi_code(index)));
+			}
+
+			const unsigned cell = quantization_table::cellOf(
+				rgb{static_cast<std::uint8_t>(slot >> 16),
+					static_cast<std::uint8_t>(slot >> 8),
+					static_cast<std::uint8_t>(slot)});
+			return depth == INDEXED_256
+					   ? style::indexedColor(table.indexed[cell])
+					   : style::ansiColor(
+							 static_cast<int>(ansi_code(table.ansi[cell])));
+		}
+	}   // namespace detail
+
+	inline style style::quantized(const ColorDepth depth) const noexcept
+	{
+		return depth == TRUECOLOR
+				   ? *this
+				   : (depth == PLAIN
+						  ? style()
+						  : style(attributes,
+								  detail::quantize_slot(foreground, depth),
+								  detail::quantize_slot(background, depth)));
+	}
+
+	/**
+	 * Class representing a terminal SGR (Select Graphic Rendition).
+	 *
+	 * @class sgr
+	 * Wraps a style and provides operations for creating SGR escape
+	 * sequences using easy to remember mnemonics.
+	 *
+	 * See
+	 * https://en.wikipedia.org/wiki/ANSI_escape_code#SGR_(Select_Graphic_Rendition)_parameters
+	 * for more information.
+	 */
+
+	class sgr
+	{
+
+		/**
+		 * Combines the given SGRs into a single SGR.
+		 *
+		 * Combining merges the underlying styles rather than concatenating
+		 * escape sequences; see style::merge().
+		 *
+		 * @param  left  Left SGR to be combined
+		 * @param  right Right SGR to be combined
+		 * @return     Combined SGR
+		 * @see operator,(const sgr & left, const sgr & right)
+		 */
+
+		friend constexpr sgr operator+(const sgr & left, const sgr & right)
+		{
+			return sgr(left.value.merge(right.value));
+		}
+
+		/**
+		 * Combines the given SGRs into a single SGR.
+		 *
+		 * @param  left  Left SGR to be combined
+		 * @param  right Right SGR to be combined
+		 * @return     Combined SGR
+		 * @see operator+(const sgr & left, const sgr & right)
+		 */
+
+		friend constexpr sgr operator,(const sgr & left, const sgr & right)
+		{
+			return left + right;
+		}
+
+		friend constexpr bool operator==(const sgr & left, const sgr & right)
+		{
+			return left.value == right.value;
+		}
+
+		friend constexpr bool operator!=(const sgr & left, const sgr & right)
+		{
+			return left.value != right.value;
+		}
+
+	public:
+		sgr() = delete;
+		~sgr() = default;
+
+		/**
+		 * Non-color SGR codes.
+		 */
+
+		enum SGRCode
+		{
+			RESET = 0,
+			BOLD = 1,
+			FAINT = 2,
+			ITALIC = 3,
+			UNDERLINE = 4,
+			BLINK_SLOW = 5,
+			BLINK_FAST = 6,
+			REVERSE = 7,
+			CONCEAL = 8,
+			STRIKE = 9,
+			FRAME = 51,
+			ENCIRCLE = 52,
+			OVERLINE = 53
+		};
+
+		/**
+		 * Construct an sgr with the given SGR code.
+		 *
+		 * @param code SGR code
+		 */
+
+		constexpr sgr(const SGRCode code) : value(style::fromCode(code)) {}
+
+		/**
+		 * Construct an sgr applying the given style.
+		 *
+		 * Marked explicit to prevent automatic conversion of styles to SGRs
+		 * when not desired.
+		 *
+		 * @param value style to apply
+		 */
+
+		explicit constexpr sgr(const style & value) : value(value) {}
+
+		/**
+		 * Retrieve the style applied by this sgr.
+		 *
+		 * @return style applied by this sgr
+		 */
+
+		constexpr const style & getStyle() const { return value; }
+
+		/**
+		 * Retrieve the escape sequence string represented by this sgr.
+		 *
+		 * The std::string produced by this method can be directly printed,
+		 * but this does not provide the automatic reset functionality of
+		 * stream insertion of the sgr class. It is thus the programmer's
+		 * responsibility to print a reset SGR (or not).
+		 *
+		 * @return std::string representing this sgr
+		 */
+
+		std::string toString() const { return value.toString(); }
+
+		/**
+		 * Compute the exact length of the escape sequence of this sgr.
+		 *
+		 * @return Number of bytes written by writeTo()
+		 * @see style::renderedSize()
+		 */
+
+		std::size_t renderedSize() const noexcept
+		{
+			return value.renderedSize();
+		}
+
+		/**
+		 * Write the escape sequence of this sgr into a buffer without
+		 * allocating.
+		 *
+		 * @param  out Buffer of at least renderedSize() bytes
+		 * @return     Pointer past the last character written
+		 * @see style::writeTo()
+		 */
+
+		char * writeTo(char * out) const noexcept
+		{
+			return value.writeTo(out);
+		}
+
+		/**
+		 * Append the escape sequence of this sgr to a std::string.
+		 *
+		 * @param out std::string to append to
+		 * @see style::appendTo()
+		 */
+
+		void appendTo(std::string & out) const { value.appendTo(out); }
+
+		/**
+		 * Render the escape sequence of this sgr into an inline buffer.
+		 *
+		 * @return Rendered escape sequence
+		 * @see style::render()
+		 */
+
+		rendered_style render() const noexcept { return value.render(); }
+
+		/**
+		 * Fit the colors of this sgr into a color depth.
+		 *
+		 * @param  depth Color depth to fit the colors into
+		 * @return       sgr using only colors within the given depth
+		 * @see style::quantized()
+		 */
+
+		sgr quantized(const ColorDepth depth) const noexcept
+		{
+			return sgr(value.quantized(depth));
+		}
+
+	private:
+		style value;
+	};
+
+	CPP_SGR_CONSTANT sgr reset = sgr(sgr::RESET); /**< Clear all SGRs */
+
+	// most commonly supported SGRs
+	CPP_SGR_CONSTANT sgr underline =
+		sgr(sgr::UNDERLINE); /**< Underlined text */
+	CPP_SGR_CONSTANT sgr bold = sgr(sgr::BOLD); /**< Bold text */
+	CPP_SGR_CONSTANT sgr reverse =
+		sgr(sgr::REVERSE); /**< Swapped foreground and background colors */
+
+	// rarely supported SGRs
+	CPP_SGR_CONSTANT sgr faint = sgr(sgr::FAINT);   /**< Faint text */
+	CPP_SGR_CONSTANT sgr italic = sgr(sgr::ITALIC); /**< Italic text */
+	CPP_SGR_CONSTANT sgr blink_slow =
+		sgr(sgr::BLINK_SLOW); /**< Slow-blinking text */
+	CPP_SGR_CONSTANT sgr blink_fast =
+		sgr(sgr::BLINK_FAST); /**< Fast-blinking text */
+	CPP_SGR_CONSTANT sgr conceal = sgr(sgr::CONCEAL); /**< Concealed text */
+	CPP_SGR_CONSTANT sgr strike = sgr(sgr::STRIKE); /**< Struckthrough text */
+	CPP_SGR_CONSTANT sgr frame = sgr(sgr::FRAME); /**< Framed text */
+	CPP_SGR_CONSTANT sgr encircle = sgr(sgr::ENCIRCLE); /**< Encircled text */
+	CPP_SGR_CONSTANT sgr overline = sgr(sgr::OVERLINE); /**< Overlined text */
+
+	/**
+	 * Exception indicating a color component outside the range [0,255] was
+	 * passed to an 8-bit or 24-bit color constructor.
+	 *
+	 * @class invalid_color_component
+	 */
+	struct invalid_color_component : public std::exception
+	{
+
+		/**
+		 * Returns a text description of the error causing this exception.
+		 *
+		 * @return description of the error causing this exception
+		 */
+		const char * what() const throw()
+		{
+			return "initialize color sgr with color component outside "
+				   "[0,255]";
+		}
+	};
+
+	/**
+	 * Class representing a terminal color SGR.
+	 *
+	 * @class color
+	 * See https://en.wikipedia.org/wiki/ANSI_escape_code#Colors
+	 * for more information.
+	 */
+	class color : public sgr
+	{
+	public:
+		color() = delete;
+		~color() = default;
+
+		/**
+		 * 3/4 bit color codes.
+		 */
+		enum ANSIColor
+		{
+			BLACK = 30,
+			RED,
+			GREEN,
+			YELLOW,
+			BLUE,
+			MAGENTA,
+			CYAN,
+			WHITE,
+			BRIGHT_BLACK = 90,
+			BRIGHT_RED,
+			BRIGHT_GREEN,
+			BRIGHT_YELLOW,
+			BRIGHT_BLUE,
+			BRIGHT_MAGENTA,
+			BRIGHT_CYAN,
+			BRIGHT_WHITE
+		};
+
+		/**
+		 * Construct a 3/4 bit foreground color SGR.
+		 *
+		 * @param  code 3/4 bit color code
+		 * @return      sgr to set the foreground to the given color
+		 */
+		static constexpr color fg(const ANSIColor code)
+		{
+			return color(style::ansiColor(code), true);
+		}
+
+		/**
+		 * Construct an 8-bit indexed foreground color SGR.
+		 *
+		 * The index must be an integer between 0 and 255 inclusive.
+		 *
+		 * @param  index 8-bit color index
+		 * @return       sgr to set the foreground to the given color
+		 */
+		static constexpr color fg256(const int index)
+		{
+			return color(checkedIndex(index), true);
+		}
+
+		/**
+		 * Construct a 24-bit foreground color SGR.
+		 *
+		 * The color components must be integers between 0 and 255 inclusive.
+		 *
+		 * @param  r 8-bit red component
+		 * @param  g 8-bit green component
+		 * @param  b 8-bit blue component
+		 * @return   sgr to set the foreground to the given color
+		 */
+		static constexpr color fg(const int r, const int g, const int b)
+		{
+			return color(checkedRGB(r, g, b), true);
+		}
+
+		/**
+		 * Construct a 24-bit foreground color SGR.
+		 *
+		 * @param  value 24-bit color
+		 * @return       sgr to set the foreground to the given color
+		 */
+		static constexpr color fg(const rgb & value)
+		{
+			return color(style::rgbColor(value), true);
+		}
+
+		/**
+		 * Construct a 3/4 bit background color SGR.
+		 *
+		 * @param  code 3/4 bit color code
+		 * @return      sgr to set the background to the given color
+		 */
+		static constexpr const color bg(const ANSIColor code)
+		{
+			return color(style::ansiColor(code), false);
+		}
+
+		/**
+		 * Construct an 8-bit indexed background color SGR.
+		 *
+		 * The index must be an integer between 0 and 255 inclusive.
+		 *
+		 * @param  index 8-bit color index
+		 * @return       sgr to set the background to the given color
+		 */
+		static constexpr color bg256(const int index)
+		{
+			return color(checkedIndex(index), false);
+		}
+
+		/**
+		 * Construct a 24-bit background color SGR.
+		 *
+		 * The color components must be integers between 0 and 255 inclusive.
+		 *
+		 * @param  r 8-bit red component
+		 * @param  g 8-bit green component
+		 * @param  b 8-bit blue component
+		 * @return   sgr to set the background to the given color
+		 */
+		static constexpr color bg(const int r, const int g, const int b)
+		{
+			return color(checkedRGB(r, g, b), false);
+		}
+
+		/**
+		 * Construct a 24-bit background color SGR.
+		 *
+		 * @param  value 24-bit color
+		 * @return       sgr to set the background to the given color
+		 */
+		static constexpr color bg(const rgb & value)
+		{
+			return color(style::rgbColor(value), false);
+		}
+
+	private:
+		/**
+		 * Private constructor for color SGRs.
+		 *
+		 * @param slot       Packed color slot
+		 * @param foreground true if foreground color, else false
+		 */
+		constexpr color(const std::uint32_t slot, bool foreground) :
+			sgr(style(0, foreground ? slot : 0, foreground ? 0 : slot))
+		{}
+
+		/**
+		 * Pack an 8-bit color index, verifying it is in the range [0,255].
+		 *
+		 * @param  index 8-bit color index
+		 * @return       Packed color slot
+		 * @throw invalid_color_component if the index is out of range
+		 */
+		static constexpr std::uint32_t checkedIndex(const int index)
+		{
+			return verifyColorComponent(index)
+					   ? style::indexedColor(index)
+					   : throw invalid_color_component();
+		}
+
+		/**
+		 * Pack a 24-bit color, verifying each component is in the range
+		 * [0,255] before anything else is done.
+		 *
+		 * @param  r 8-bit red component
+		 * @param  g 8-bit green component
+		 * @param  b 8-bit blue component
+		 * @return   Packed color slot
+		 * @throw invalid_color_component if a component is out of range
+		 */
+		static constexpr std::uint32_t checkedRGB(const int r,
+												  const int g,
+												  const int b)
+		{
+			return verifyColorComponent(r) && verifyColorComponent(g) &&
+						   verifyColorComponent(b)
+					   ? style::rgbColor(r, g, b)
+					   : throw invalid_color_component();
+		}
+
+		/**
+		 * Verify an RGB component in the range [0,255].
+		 *
+		 * @param  c 8-bit color component
+		 * @return   True if valid, else false
+		 */
+		static constexpr bool verifyColorComponent(const int c) noexcept
+		{
+			return c <= 255 && c >= 0;
+		}
+	};
+
+	// syntactic sugar - shorthands for the constructors
+
+	CPP_SGR_CONSTANT sgr black_fg =
+		color::fg(color::BLACK); /**< Black foreground */
+	CPP_SGR_CONSTANT sgr red_fg = color::fg(color::RED); /**< Red foreground */
+	CPP_SGR_CONSTANT sgr green_fg =
+		color::fg(color::GREEN); /**< Green foreground */
+	CPP_SGR_CONSTANT sgr yellow_fg =
+		color::fg(color::YELLOW); /**< Yellow foreground */
+	CPP_SGR_CONSTANT sgr blue_fg =
+		color::fg(color::BLUE); /**< Blue foreground */
+	CPP_SGR_CONSTANT sgr magenta_fg =
+		color::fg(color::MAGENTA); /**< Magenta foreground */
+	CPP_SGR_CONSTANT sgr cyan_fg =
+		color::fg(color::CYAN); /**< Cyan foreground */
+	CPP_SGR_CONSTANT sgr white_fg =
+		color::fg(color::WHITE); /**< White foreground */
+
+	CPP_SGR_CONSTANT sgr b_black_fg =
+		color::fg(color::BRIGHT_BLACK); /**< Bright black foreground */
+	CPP_SGR_CONSTANT sgr b_red_fg =
+		color::fg(color::BRIGHT_RED); /**< Bright red foreground */
+	CPP_SGR_CONSTANT sgr b_green_fg =
+		color::fg(color::BRIGHT_GREEN); /**< Bright green foreground */
+	CPP_SGR_CONSTANT sgr b_yellow_fg =
+		color::fg(color::BRIGHT_YELLOW); /**< Bright yellow foreground */
+	CPP_SGR_CONSTANT sgr b_blue_fg =
+		color::fg(color::BRIGHT_BLUE); /**< Bright blue foreground */
+	CPP_SGR_CONSTANT sgr b_magenta_fg =
+		color::fg(color::BRIGHT_MAGENTA); /**< Bright magenta foreground */
+	CPP_SGR_CONSTANT sgr b_cyan_fg =
+		color::fg(color::BRIGHT_CYAN); /**< Bright cyan foreground */
+	CPP_SGR_CONSTANT sgr b_white_fg =
+		color::fg(color::BRIGHT_WHITE); /**< Bright white foreground */
+
+	CPP_SGR_CONSTANT sgr black_bg =
+		color::bg(color::BLACK); /**< Black background */
+	CPP_SGR_CONSTANT sgr red_bg = color::bg(color::RED); /**< Red background */
+	CPP_SGR_CONSTANT sgr green_bg =
+		color::bg(color::GREEN); /**< Green background */
+	CPP_SGR_CONSTANT sgr yellow_bg =
+		color::bg(color::YELLOW); /**< Yellow background */
+	CPP_SGR_CONSTANT sgr blue_bg =
+		color::bg(color::BLUE); /**< Blue background */
+	CPP_SGR_CONSTANT sgr magenta_bg =
+		color::bg(color::MAGENTA); /**< Magenta background */
+	CPP_SGR_CONSTANT sgr cyan_bg =
+		color::bg(color::CYAN); /**< Cyan background */
+	CPP_SGR_CONSTANT sgr white_bg =
+		color::bg(color::WHITE); /**< White background */
+
+	CPP_SGR_CONSTANT sgr b_black_bg =
+		color::bg(color::BRIGHT_BLACK); /**< Bright black background */
+	CPP_SGR_CONSTANT sgr b_red_bg =
+		color::bg(color::BRIGHT_RED); /**< Bright red background */
+	CPP_SGR_CONSTANT sgr b_green_bg =
+		color::bg(color::BRIGHT_GREEN); /**< Bright green background */
+	CPP_SGR_CONSTANT sgr b_yellow_bg =
+		color::bg(color::BRIGHT_YELLOW); /**< Bright yellow background */
+	CPP_SGR_CONSTANT sgr b_blue_bg =
+		color::bg(color::BRIGHT_BLUE); /**< Bright blue background */
+	CPP_SGR_CONSTANT sgr b_magenta_bg =
+		color::bg(color::BRIGHT_MAGENTA); /**< Bright magenta background */
+	CPP_SGR_CONSTANT sgr b_cyan_bg =
+		color::bg(color::BRIGHT_CYAN); /**< Bright cyan background */
+	CPP_SGR_CONSTANT sgr b_white_bg =
+		color::bg(color::BRIGHT_WHITE); /**< Bright white background */
+
+	/**
+	 * Value paired with the sgr it is rendered in.
+	 *
+	 * @class styled_value
+	 * Lightweight expression object returned by styled(), referring to the
+	 * value rather than copying it, so it must not outlive the value. Output
+	 * adapters write the escape sequence of the style, the value and a reset,
+	 * or just the value if the style is empty.
+	 */
+	template<class T>
+	class styled_value
+	{
+	public:
+		/**
+		 * Pair a value with a style.
+		 *
+		 * @param s     Style to render the value in
+		 * @param value Value to render
+		 */
+		constexpr styled_value(const style & s, const T & value) noexcept :
+			value_style(s), value(value)
+		{}
+
+		/**
+		 * @return Style the value is rendered in
+		 */
+		constexpr const style & getStyle() const noexcept
+		{
+			return value_style;
+		}
+
+		/**
+		 * @return The styled value
+		 */
+		constexpr const T & getValue() const noexcept { return value; }
+
+	private:
+		style value_style;
+		const T & value;
+	};
+
+	/**
+	 * Pair a value with the sgr it should be rendered in.
+	 *
+	 * @param  s     sgr to render the value in
+	 * @param  value Value to render, referred to rather than copied
+	 * @return       styled_value referring to the value
+	 */
+	template<class T>
+	constexpr styled_value<T> styled(const sgr & s,
+									 const T & value) noexcept
+	{
+		return styled_value<T>(s.getStyle(), value);
+	}
+
+	/**
+	 * Pair a value with the style it should be rendered in.
+	 *
+	 * @param  s     Style to render the value in
+	 * @param  value Value to render, referred to rather than copied
+	 * @return       styled_value referring to the value
+	 */
+	template<class T>
+	constexpr styled_value<T> styled(const style & s,
+									 const T & value) noexcept
+	{
+		return styled_value<T>(s, value);
+	}
+
+	namespace detail
+	{
+		template<class... Values>
+		struct value_list;
+
+		/**
+		 * Empty list of values.
+		 */
+		template<>
+		struct value_list<>
+		{
+			constexpr value_list() noexcept {}
+
+			template<class Visitor>
+			void forEach(Visitor &) const
+			{}
+		};
+
+		/**
+		 * List of references to values of different types.
+		 */
+		template<class First, class... Rest>
+		struct value_list<First, Rest...>
+		{
+			constexpr value_list(const First & first,
+								 const Rest &... rest) noexcept :
+				first(first), rest(rest...)
+			{}
+
+			/**
+			 * Call a visitor with each value in order.
+			 *
+			 * @param visitor Function object accepting every value type
+			 */
+			template<class Visitor>
+			void forEach(Visitor & visitor) const
+			{
+				visitor(first);
+				rest.forEach(visitor);
+			}
+
+			const First & first;
+			value_list<Rest...> rest;
+		};
+	}   // namespace detail
+
+	/**
+	 * Sequence of values sharing the sgr they are rendered in.
+	 *
+	 * @class styled_values
+	 * Lightweight expression object returned by styled() for several values,
+	 * referring to them rather than copying them. Output adapters write the
+	 * escape sequence of the style once, then every value, then one reset.
+	 */
+	template<class... Values>
+	class styled_values
+	{
+	public:
+		/**
+		 * Pair values with a style.
+		 *
+		 * @param s      Style to render the values in
+		 * @param values Values to render
+		 */
+		constexpr styled_values(const style & s,
+								const Values &... values) noexcept :
+			value_style(s), values(values...)
+		{}
+
+		/**
+		 * @return Style the values are rendered in
+		 */
+		constexpr const style & getStyle() const noexcept
+		{
+			return value_style;
+		}
+
+		/**
+		 * Call a visitor with each value in order.
+		 *
+		 * @param visitor Function object accepting every value type
+		 */
+		template<class Visitor>
+		void forEach(Visitor & visitor) const
+		{
+			values.forEach(visitor);
+		}
+
+	private:
+		style value_style;
+		detail::value_list<Values...> values;
+	};
+
+	/**
+	 * Pair several values with the sgr they should be rendered in, sharing
+	 * one escape sequence and one reset, e.g.
+	 * styled(bold + red_fg, "x=", x, " y=", y).
+	 *
+	 * @param  s      sgr to render the values in
+	 * @param  first  First value
+	 * @param  second Second value
+	 * @param  rest   Further values
+	 * @return        styled_values referring to the values
+	 */
+	template<class First, class Second, class... Rest>
+	constexpr styled_values<First, Second, Rest...>
+		styled(const sgr & s,
+			   const First & first,
+			   const Second & second,
+			   const Rest &... rest) noexcept
+	{
+		return styled_values<First, Second, Rest...>(
+			s.getStyle(), first, second, rest...);
+	}
+
+	/**
+	 * Pair several values with the style they should be rendered in, sharing
+	 * one escape sequence and one reset.
+	 *
+	 * @param  s      Style to render the values in
+	 * @param  first  First value
+	 * @param  second Second value
+	 * @param  rest   Further values
+	 * @return        styled_values referring to the values
+	 */
+	template<class First, class Second, class... Rest>
+	constexpr styled_values<First, Second, Rest...>
+		styled(const style & s,
+			   const First & first,
+			   const Second & second,
+			   const Rest &... rest) noexcept
+	{
+		return styled_values<First, Second, Rest...>(
+			s, first, second, rest...);
+	}
+
+	/**
+	 * Find the perceptually nearest color of the xterm 256 color palette,
+	 * excluding the terminal dependent first 16 entries.
+	 *
+	 * @param  value 24-bit color
+	 * @return       Palette index in the range [16,255]
+	 */
+	inline std::uint8_t nearest_indexed(const rgb & value) noexcept
+	{
+		return detail::quantization()
+			.indexed[detail::quantization_table::cellOf(value)];
+	}
+
+	/**
+	 * Find the perceptually nearest 3/4-bit color, assuming xterm's default
+	 * colors.
+	 *
+	 * @param  value 24-bit color
+	 * @return       3/4-bit color code
+	 */
+	inline color::ANSIColor nearest_ansi(const rgb & value) noexcept
+	{
+		return static_cast<color::ANSIColor>(detail::ansi_code(
+			detail::quantization()
+				.ansi[detail::quantization_table::cellOf(value)]));
+	}
+
+	/**
+	 * Find the nearest xterm 256 color palette entries of an array of colors.
+	 *
+	 * @param values  24-bit colors
+	 * @param count   Number of colors
+	 * @param indices Receives a palette index in [16,255] per color
+	 * @see nearest_indexed(const rgb &)
+	 */
+	inline void nearest_indexed(const rgb * values,
+								const std::size_t count,
+								std::uint8_t * indices) noexcept
+	{
+		const std::uint8_t * table = detail::quantization().indexed;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			indices[i] = table[detail::quantization_table::cellOf(values[i])];
+		}
+	}
+
+	/**
+	 * Find the nearest 3/4-bit colors of an array of colors.
+	 *
+	 * @param values 24-bit colors
+	 * @param count  Number of colors
+	 * @param codes  Receives a 3/4-bit color code per color
+	 * @see nearest_ansi(const rgb &)
+	 */
+	inline void nearest_ansi(const rgb * values,
+							 const std::size_t count,
+							 color::ANSIColor * codes) noexcept
+	{
+		const std::uint8_t * table = detail::quantization().ansi;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			codes[i] = static_cast<color::ANSIColor>(detail::ansi_code(
+				table[detail::quantization_table::cellOf(values[i])]));
+		}
+	}
+
+	/**
+	 * Fit the colors of an array of styles into a color depth, in place.
+	 *
+	 * @param styles Styles to modify
+	 * @param count  Number of styles
+	 * @param depth  Color depth to fit the colors into
+	 * @see style::quantized()
+	 */
+	inline void quantize(style * styles,
+						 const std::size_t count,
+						 const ColorDepth depth) noexcept
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			styles[i] = styles[i].quantized(depth);
+		}
+	}
+
+	namespace detail
+	{
+		/**
+		 * Compile-time character sequence backed by a static, null-terminated
+		 * character array.
+		 */
+		template<char... Chars>
+		struct char_sequence
+		{
+			static constexpr std::size_t length = sizeof...(Chars);
+			static constexpr char data[sizeof...(Chars) + 1] = {Chars..., '\0'};
+		};
+
+		template<char... Chars>
+		constexpr char char_sequence<Chars...>::data[sizeof...(Chars) + 1];
+
+		template<class Sequence, char... Tail>
+		struct append_chars;
+
+		template<char... Chars, char... Tail>
+		struct append_chars<char_sequence<Chars...>, Tail...>
+		{
+			using type = char_sequence<Chars..., Tail...>;
+		};
+
+		template<class Sequence, unsigned Value, bool = (Value < 10)>
+		struct append_decimal;
+
+		template<class Sequence, unsigned Value>
+		struct append_decimal<Sequence, Value, true> :
+			append_chars<Sequence, char('0' + Value)>
+		{};
+
+		template<class Sequence, unsigned Value>
+		struct append_decimal<Sequence, Value, false> :
+			append_chars<typename append_decimal<Sequence, Value / 10>::type,
+						 char('0' + Value % 10)>
+		{};
+
+		template<class Sequence, int... Params>
+		struct append_params
+		{
+			using type = Sequence;
+		};
+
+		template<class Sequence, int Param>
+		struct append_params<Sequence, Param> :
+			append_decimal<Sequence, static_cast<unsigned>(Param)>
+		{};
+
+		template<class Sequence, int First, int Second, int... Rest>
+		struct append_params<Sequence, First, Second, Rest...> :
+			append_params<
+				typename append_chars<
+					typename append_decimal<Sequence,
+											static_cast<unsigned>(First)>::type,
+					';'>::type,
+				Second,
+				Rest...>
+		{};
+
+		constexpr bool valid_params() { return true; }
+
+		template<class... Rest>
+		constexpr bool valid_params(const int first, const Rest... rest)
+		{
+			return first >= 0 && first <= 255 && valid_params(rest...);
+		}
+	}   // namespace detail
+
+	/**
+	 * SGR whose escape sequence is assembled entirely at compile time.
+	 *
+	 * @class static_sgr
+	 * The parameters are raw SGR parameters, so sgr::SGRCode and
+	 * color::ANSIColor values can be used directly, e.g.
+	 * `static_sgr<sgr::BOLD, color::RED>` produces `"\033[1;31m"`. Since the
+	 * complete sequence lives in a static character array, inserting a
+	 * static_sgr performs no formatting or allocation at runtime.
+	 *
+	 * @typeparam Params SGR parameters, each in the range [0,255]
+	 */
+	template<int... Params>
+	class static_sgr
+	{
+		static_assert(detail::valid_params(Params...),
+					  "SGR parameters must be in the range [0,255]");
+
+		using sequence = typename detail::append_chars<
+			typename detail::append_params<
+				detail::char_sequence<'\033', '['>,
+				Params...>::type,
+			'm'>::type;
+
+	public:
+		/**
+		 * Retrieve the null-terminated escape sequence of this SGR.
+		 *
+		 * @return Pointer to a static character array
+		 */
+		static constexpr const char * c_str() { return sequence::data; }
+
+		/**
+		 * Retrieve the length of the escape sequence of this SGR, excluding
+		 * the null terminator.
+		 *
+		 * @return Length of the escape sequence in bytes
+		 */
+		static constexpr std::size_t size() { return sequence::length; }
+
+		/**
+		 * Retrieve the escape sequence string represented by this SGR.
+		 *
+		 * @return std::string representing this SGR
+		 * @see sgr::toString()
+		 */
+		std::string toString() const { return std::string(c_str(), size()); }
+	};
+CPP_SGR_END_NAMESPACE
+
+namespace std
+{
+	/**
+	 * Hash support for cpp_sgr::style.
+	 */
+	template<>
+	struct hash<cpp_sgr::style>
+	{
+		std::size_t operator()(const cpp_sgr::style & s) const noexcept
+		{
+			return s.hash();
+		}
+	};
+
+	/**
+	 * Hash support for cpp_sgr::sgr.
+	 */
+	template<>
+	struct hash<cpp_sgr::sgr>
+	{
+		std::size_t operator()(const cpp_sgr::sgr & s) const noexcept
+		{
+			return s.getStyle().hash();
+		}
+	};
+}   // namespace std
+
+#endif /* end of include guard: CPP_SGR_CORE_HPP */
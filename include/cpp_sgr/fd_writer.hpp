@@ -0,0 +1,359 @@
+/**
+ *  cpp_sgr file descriptor writer.
+ *
+ *  @file fd_writer.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_FD_WRITER_HPP
+#define CPP_SGR_FD_WRITER_HPP
+
+#include "core.hpp"
+
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+CPP_SGR_BEGIN_NAMESPACE
+	namespace detail
+	{
+#ifdef _WIN32
+		/**
+		 * Memory region to write, laid out like POSIX struct iovec.
+		 */
+		struct io_vector
+		{
+			void * iov_base;
+			std::size_t iov_len;
+		};
+#else
+		using io_vector = ::iovec;
+#endif
+
+		/**
+		 * Maximum number of regions written by one write_vectors() call.
+		 */
+#if defined(IOV_MAX)
+		constexpr int MAX_IO_VECTORS = IOV_MAX;
+#else
+		constexpr int MAX_IO_VECTORS = 1024;
+#endif
+
+		/**
+		 * Skip regions that have been written, shrinking the first region
+		 * that was only partially written.
+		 *
+		 * @param vectors Regions to write; advanced past the written ones
+		 * @param count   Number of regions; reduced accordingly
+		 * @param written Number of bytes written
+		 */
+		inline void advance_vectors(io_vector *& vectors,
+									int & count,
+									std::size_t written) noexcept
+		{
+			while (count > 0 && written >= vectors->iov_len)
+			{
+				written -= vectors->iov_len;
+				++vectors;
+				--count;
+			}
+			if (count > 0)
+			{
+				vectors->iov_base =
+					static_cast<char *>(vectors->iov_base) + written;
+				vectors->iov_len -= written;
+			}
+		}
+
+		/**
+		 * Write memory regions to a file descriptor with as few system calls
+		 * as possible, retrying after partial writes and interruptions. The
+		 * regions are modified to track progress.
+		 *
+		 * @param  fd      File descriptor to write to
+		 * @param  vectors Regions to write
+		 * @param  count   Number of regions, at most MAX_IO_VECTORS
+		 * @return         True if all regions were written, else false
+		 */
+		inline bool write_vectors(const int fd, io_vector * vectors, int count)
+		{
+			// Skip empty leading regions, so nothing is written for nothing
+			advance_vectors(vectors, count, 0);
+			while (count > 0)
+			{
+#ifdef _WIN32
+				const unsigned length =
+					static_cast<unsigned>(vectors->iov_len);
+				const int written = _write(fd, vectors->iov_base, length);
+#else
+				const ssize_t written = ::writev(fd, vectors, count);
+#endif
+				if (written < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+					return false;
+				}
+				advance_vectors(
+					vectors, count, static_cast<std::size_t>(written));
+			}
+			return true;
+		}
+	}   // namespace detail
+
+	/**
+	 * Writer of styled messages straight to a file descriptor.
+	 *
+	 * @class fd_writer
+	 * Each message is written with one writev() call gathering the escape
+	 * sequence of its sgr, the caller's payload, which is never copied, and a
+	 * reset; messages in the default rendition are written without either.
+	 * Partial writes and interruptions are retried. Alternatively, messages
+	 * can be queued and written in batches, packing as many messages into a
+	 * single writev() call as the system allows.
+	 *
+	 * Styles are fit into the color depth given on construction; with PLAIN
+	 * or CPP_SGR_DISABLE defined, only the payloads are written. On Windows,
+	 * which lacks writev(), each region is written separately.
+	 */
+	class fd_writer
+	{
+	public:
+		/**
+		 * Construct a writer for a file descriptor.
+		 *
+		 * @param fd    File descriptor to write to
+		 * @param depth Color depth to fit styles into
+		 */
+		explicit fd_writer(const int fd, const ColorDepth depth = TRUECOLOR) :
+			fd(fd), depth(depth)
+		{}
+
+		fd_writer(const fd_writer &) = delete;
+		fd_writer & operator=(const fd_writer &) = delete;
+
+		/**
+		 * Write all queued messages.
+		 */
+		~fd_writer() { flush(); }
+
+		/**
+		 * Write a message rendered in the given sgr, after any queued ones.
+		 *
+		 * @param  s      sgr to render the message in
+		 * @param  data   Payload of the message
+		 * @param  length Length of the payload in bytes
+		 * @return        True if the queued messages and this one were all
+		 * written, else false
+		 */
+		bool write(const sgr & s, const char * data, const std::size_t length)
+		{
+			if (!flush())
+			{
+				return false;
+			}
+			const rendered_style prefix = render(s);
+			detail::io_vector vectors[3];
+			const int count = gather(vectors, prefix, data, length);
+			return detail::write_vectors(fd, vectors, count);
+		}
+
+		/**
+		 * Write a message rendered in the given sgr, after any queued ones.
+		 *
+		 * @param  s    sgr to render the message in
+		 * @param  text Payload of the message
+		 * @return      True if the queued messages and this one were all
+		 * written, else false
+		 */
+		bool write(const sgr & s, const std::string & text)
+		{
+			return write(s, text.data(), text.size());
+		}
+
+		/**
+		 * Queue a message rendered in the given sgr for a batched write. The
+		 * payload is not copied and must remain valid until the message has
+		 * been written by flush(), a later write() or the destructor. When
+		 * the batch reaches the system's limit of regions per writev() call,
+		 * it is written first.
+		 *
+		 * @param  s      sgr to render the message in
+		 * @param  data   Payload of the message
+		 * @param  length Length of the payload in bytes
+		 * @return        False if writing a full batch failed, else true
+		 */
+		bool queue(const sgr & s, const char * data, const std::size_t length)
+		{
+			bool success = true;
+			if (vectors.size() + 3 > static_cast<std::size_t>(MAX_VECTORS))
+			{
+				success = flush();
+			}
+			if (prefixes.empty())
+			{
+				// Allocated once, so queued regions never dangle
+				prefixes.resize(MAX_VECTORS / 3, style().render());
+				vectors.reserve(MAX_VECTORS);
+			}
+
+			const rendered_style prefix = render(s);
+			const rendered_style * stored = &prefix;
+			if (!prefix.empty())
+			{
+				stored = &(prefixes[usedPrefixes++] = prefix);
+			}
+			detail::io_vector message[3];
+			const int count = gather(message, *stored, data, length);
+			vectors.insert(vectors.end(), message, message + count);
+			++queued;
+			return success;
+		}
+
+		/**
+		 * Queue a message rendered in the given sgr for a batched write.
+		 *
+		 * @param  s    sgr to render the message in
+		 * @param  text Payload of the message; must outlive the write
+		 * @return      False if writing a full batch failed, else true
+		 */
+		bool queue(const sgr & s, const std::string & text)
+		{
+			return queue(s, text.data(), text.size());
+		}
+
+		/**
+		 * Write all queued messages in one writev() call, retrying after
+		 * partial writes and interruptions. The queue is emptied even if
+		 * writing fails.
+		 *
+		 * @return True if all queued messages were written, else false
+		 */
+		bool flush()
+		{
+			if (vectors.empty())
+			{
+				return true;
+			}
+			const bool success = detail::write_vectors(
+				fd, vectors.data(), static_cast<int>(vectors.size()));
+			vectors.clear();
+			usedPrefixes = 0;
+			queued = 0;
+			return success;
+		}
+
+		/**
+		 * @return Number of queued messages not written yet
+		 */
+		std::size_t pending() const { return queued; }
+
+	private:
+		/**
+		 * Regions per writev() call, a multiple of the three regions of a
+		 * message.
+		 */
+		static constexpr int MAX_VECTORS = detail::MAX_IO_VECTORS / 3 * 3;
+
+		int fd;
+		ColorDepth depth;
+		std::vector<detail::io_vector> vectors;
+		std::vector<rendered_style> prefixes;
+		std::size_t usedPrefixes = 0;
+		std::size_t queued = 0;
+
+		/**
+		 * Render the escape sequence starting a message.
+		 *
+		 * @param  s sgr of the message
+		 * @return   Escape sequence, empty if nothing needs to be written
+		 */
+		rendered_style render(const sgr & s) const noexcept
+		{
+#ifdef CPP_SGR_DISABLE
+			static_cast<void>(s);
+			return style().render();
+#else
+			return s.getStyle().effective().quantized(depth).render();
+#endif
+		}
+
+		/**
+		 * Fill in the regions of a message.
+		 *
+		 * @param  out    Array of at least three regions
+		 * @param  prefix Escape sequence starting the message
+		 * @param  data   Payload of the message
+		 * @param  length Length of the payload in bytes
+		 * @return        Number of regions filled in
+		 */
+		static int gather(detail::io_vector * out,
+						  const rendered_style & prefix,
+						  const char * data,
+						  const std::size_t length) noexcept
+		{
+			using reset_sequence = static_sgr<sgr::RESET>;
+			if (prefix.empty())
+			{
+				out[0] = region(data, length);
+				return 1;
+			}
+			out[0] = region(prefix.data(), prefix.size());
+			out[1] = region(data, length);
+			out[2] = region(reset_sequence::c_str(), reset_sequence::size());
+			return 3;
+		}
+
+		/**
+		 * @param  data   Start of a memory region
+		 * @param  length Length of the region in bytes
+		 * @return        Region to write
+		 */
+		static detail::io_vector region(const char * data,
+										const std::size_t length) noexcept
+		{
+			detail::io_vector result;
+			result.iov_base = const_cast<char *>(data);
+			result.iov_len = length;
+			return result;
+		}
+	};
+CPP_SGR_END_NAMESPACE
+
+#endif /* end of include guard: CPP_SGR_FD_WRITER_HPP */
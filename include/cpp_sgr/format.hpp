@@ -0,0 +1,259 @@
+/**
+ *  cpp_sgr std::format integration.
+ *
+ *  @file format.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_FORMAT_HPP
+#define CPP_SGR_FORMAT_HPP
+
+#include "core.hpp"
+
+#ifdef __has_include
+#if __has_include(<format>)
+#include <format>
+#endif
+#endif
+
+/**
+ * Defined to 1 if std::format is available and the formatters below are
+ * provided, else 0.
+ */
+#if defined(__cpp_lib_format) && __cpp_lib_format >= 201907L
+#define CPP_SGR_HAS_FORMAT 1
+#else
+#define CPP_SGR_HAS_FORMAT 0
+#endif
+
+#if CPP_SGR_HAS_FORMAT
+
+#include <algorithm>
+#include <type_traits>
+
+CPP_SGR_BEGIN_NAMESPACE
+	namespace detail
+	{
+		/**
+		 * Copy the escape sequence of a style to an output iterator. With
+		 * CPP_SGR_DISABLE defined, nothing is copied.
+		 *
+		 * @param  s   Style to render
+		 * @param  out Output iterator to copy to
+		 * @return     Output iterator past the last character copied
+		 */
+		template<class OutputIt>
+		OutputIt format_style(const style & s, OutputIt out)
+		{
+#ifdef CPP_SGR_DISABLE
+			static_cast<void>(s);
+			return out;
+#else
+			const rendered_style rendered = s.render();
+			return std::copy(
+				rendered.data(), rendered.data() + rendered.size(), out);
+#endif
+		}
+
+		/**
+		 * Copy the escape sequence of a static_sgr to an output iterator.
+		 * With CPP_SGR_DISABLE defined, nothing is copied.
+		 *
+		 * @param  out Output iterator to copy to
+		 * @return     Output iterator past the last character copied
+		 * @typeparam Static static_sgr to copy
+		 */
+		template<class Static, class OutputIt>
+		OutputIt format_static(OutputIt out)
+		{
+#ifdef CPP_SGR_DISABLE
+			return out;
+#else
+			return std::copy(Static::c_str(), Static::c_str() + Static::size(),
+							 out);
+#endif
+		}
+
+		/**
+		 * Copy the reset escape sequence to an output iterator. With
+		 * CPP_SGR_DISABLE defined, nothing is copied.
+		 *
+		 * @param  out Output iterator to copy to
+		 * @return     Output iterator past the last character copied
+		 */
+		template<class OutputIt>
+		OutputIt format_reset(OutputIt out)
+		{
+			return format_static<static_sgr<sgr::RESET>>(out);
+		}
+
+		/**
+		 * Base of formatters taking no format specification.
+		 */
+		struct unspecified_formatter
+		{
+			constexpr std::format_parse_context::iterator
+				parse(std::format_parse_context & context)
+			{
+				const auto it = context.begin();
+				if (it != context.end() && *it != '}')
+				{
+					throw std::format_error(
+						"cpp_sgr SGRs and styled_values take no format "
+						"specification");
+				}
+				return it;
+			}
+		};
+
+		/**
+		 * Visitor formatting each value of a styled_values with its own
+		 * formatter.
+		 */
+		template<class OutputIt>
+		struct format_visitor
+		{
+			OutputIt out;
+
+			template<class T>
+			void operator()(const T & value)
+			{
+				out = std::format_to(out, "{}", value);
+			}
+		};
+	}   // namespace detail
+CPP_SGR_END_NAMESPACE
+
+namespace std
+{
+	/**
+	 * std::format support for cpp_sgr::sgr. Formats the escape sequence of
+	 * the sgr, taking no format specification. Unlike stream insertion, no
+	 * reset follows automatically; format cpp_sgr::reset or use
+	 * cpp_sgr::styled() to end the rendition.
+	 */
+	template<>
+	struct formatter<cpp_sgr::sgr, char> :
+		cpp_sgr::detail::unspecified_formatter
+	{
+		template<class FormatContext>
+		typename FormatContext::iterator format(const cpp_sgr::sgr & s,
+												FormatContext & context) const
+		{
+			return cpp_sgr::detail::format_style(s.getStyle(), context.out());
+		}
+	};
+
+	/**
+	 * std::format support for cpp_sgr::color, which formatter lookup does
+	 * not find through its base cpp_sgr::sgr.
+	 */
+	template<>
+	struct formatter<cpp_sgr::color, char> : formatter<cpp_sgr::sgr, char>
+	{};
+
+	/**
+	 * std::format support for cpp_sgr::static_sgr. Formats its escape
+	 * sequence like that of a cpp_sgr::sgr.
+	 */
+	template<int... Params>
+	struct formatter<cpp_sgr::static_sgr<Params...>, char> :
+		cpp_sgr::detail::unspecified_formatter
+	{
+		template<class FormatContext>
+		typename FormatContext::iterator
+			format(const cpp_sgr::static_sgr<Params...> &,
+				   FormatContext & context) const
+		{
+			return cpp_sgr::detail::format_static<
+				cpp_sgr::static_sgr<Params...>>(context.out());
+		}
+	};
+
+	/**
+	 * std::format support for cpp_sgr::styled_value. Formats the escape
+	 * sequence of the style, the value formatted by its own formatter and a
+	 * reset, directly into the output. The format specification applies to
+	 * the value, so widths count only its characters, not escape sequences.
+	 */
+	template<class T>
+	struct formatter<cpp_sgr::styled_value<T>, char> :
+		formatter<typename remove_cv<T>::type, char>
+	{
+		template<class FormatContext>
+		typename FormatContext::iterator
+			format(const cpp_sgr::styled_value<T> & v,
+				   FormatContext & context) const
+		{
+			using base = formatter<typename remove_cv<T>::type, char>;
+			const cpp_sgr::style & s = v.getStyle();
+			if (s.empty())
+			{
+				return base::format(v.getValue(), context);
+			}
+
+			context.advance_to(cpp_sgr::detail::format_style(s, context.out()));
+			return cpp_sgr::detail::format_reset(
+				base::format(v.getValue(), context));
+		}
+	};
+
+	/**
+	 * std::format support for cpp_sgr::styled_values. Formats the escape
+	 * sequence of the style once, every value with its own formatter and
+	 * default format specification, and one reset. It takes no format
+	 * specification itself.
+	 */
+	template<class... Values>
+	struct formatter<cpp_sgr::styled_values<Values...>, char> :
+		cpp_sgr::detail::unspecified_formatter
+	{
+		template<class FormatContext>
+		typename FormatContext::iterator
+			format(const cpp_sgr::styled_values<Values...> & v,
+				   FormatContext & context) const
+		{
+			const cpp_sgr::style & s = v.getStyle();
+			cpp_sgr::detail::format_visitor<typename FormatContext::iterator>
+				visitor{context.out()};
+			if (s.empty())
+			{
+				v.forEach(visitor);
+				return visitor.out;
+			}
+
+			visitor.out = cpp_sgr::detail::format_style(s, visitor.out);
+			v.forEach(visitor);
+			return cpp_sgr::detail::format_reset(visitor.out);
+		}
+	};
+}   // namespace std
+
+#endif
+
+#endif /* end of include guard: CPP_SGR_FORMAT_HPP */
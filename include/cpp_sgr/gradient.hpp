@@ -0,0 +1,336 @@
+/**
+ *  cpp_sgr gradient text renderer.
+ *
+ *  @file gradient.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_GRADIENT_HPP
+#define CPP_SGR_GRADIENT_HPP
+
+#include "core.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+CPP_SGR_BEGIN_NAMESPACE
+	/**
+	 * Renderer coloring text with a gradient, one color per character.
+	 *
+	 * @class gradient
+	 * The gradient runs through a list of evenly spaced color stops, from the
+	 * first character of the text to the last. Characters are UTF-8 code
+	 * points, so a multi-byte glyph takes a single step of the gradient.
+	 * Colors are interpolated in 16.16 fixed point, fitted into the
+	 * gradient's color depth, and an escape sequence is only written where
+	 * the color differs from that of the previous character. The whole text
+	 * is rendered into a single output buffer, ending in the default
+	 * rendition. With CPP_SGR_DISABLE defined, the text is copied unchanged.
+	 */
+	class gradient
+	{
+	public:
+		/**
+		 * Construct a gradient between two colors.
+		 *
+		 * @param start      Color of the first character
+		 * @param end        Color of the last character
+		 * @param foreground True to color the foreground, else the background
+		 */
+		gradient(const rgb & start, const rgb & end, const bool foreground = true) :
+			stops{start, end}, base(), depth(TRUECOLOR), foreground(foreground)
+		{}
+
+		/**
+		 * Construct a gradient through evenly spaced color stops. Without
+		 * any stops, text is rendered in the base style only.
+		 *
+		 * @param stops      Colors to pass through, in order
+		 * @param foreground True to color the foreground, else the background
+		 */
+		gradient(const std::initializer_list<rgb> stops,
+				 const bool foreground = true) :
+			stops(stops),
+			base(), depth(TRUECOLOR), foreground(foreground)
+		{}
+
+		/**
+		 * Construct a gradient through evenly spaced color stops. Without
+		 * any stops, text is rendered in the base style only.
+		 *
+		 * @param stops      Colors to pass through, in order
+		 * @param count      Number of color stops
+		 * @param foreground True to color the foreground, else the background
+		 */
+		gradient(const rgb * stops,
+				 const std::size_t count,
+				 const bool foreground = true) :
+			stops(stops, stops + count),
+			base(), depth(TRUECOLOR), foreground(foreground)
+		{}
+
+		/**
+		 * Set the sgr every character is rendered in besides its color, e.g.
+		 * bold. Its color on the gradient's side is overridden.
+		 *
+		 * @param  s sgr to combine with the gradient colors
+		 * @return   Reference to this gradient
+		 */
+		gradient & setStyle(const sgr & s)
+		{
+			base = s.getStyle().effective();
+			return *this;
+		}
+
+		/**
+		 * Set the color depth the gradient colors are fitted into.
+		 *
+		 * @param  value Color depth of the terminal written to
+		 * @return       Reference to this gradient
+		 */
+		gradient & setDepth(const ColorDepth value)
+		{
+			depth = value;
+			return *this;
+		}
+
+		/**
+		 * Compute the colors of a number of evenly spaced steps along the
+		 * gradient.
+		 *
+		 * @param steps Number of steps
+		 * @param out   Receives the color of each step
+		 */
+		void colors(const std::size_t steps, rgb * out) const
+		{
+			if (stops.empty())
+			{
+				return;
+			}
+			cursor position(stops, steps);
+			for (std::size_t i = 0; i < steps; ++i)
+			{
+				out[i] = position.next();
+			}
+		}
+
+		/**
+		 * Render text with this gradient, appending the output to a
+		 * std::string with at most one allocation.
+		 *
+		 * @param out    std::string to append to
+		 * @param text   UTF-8 text to render
+		 * @param length Length of the text in bytes
+		 */
+		void appendTo(std::string & out,
+					  const char * text,
+					  const std::size_t length) const
+		{
+#ifdef CPP_SGR_DISABLE
+			out.append(text, length);
+#else
+			const std::size_t steps = codePoints(text, length);
+			if (steps == 0)
+			{
+				return;
+			}
+
+			// Every step and the final reset write at most one transition
+			const std::size_t start = out.size();
+			out.resize(start + length +
+					   (steps + 1) * style::MAX_TRANSITION_SIZE);
+			char * const begin = &out[start];
+			char * p = begin;
+
+			cursor position(stops, steps);
+			style current;
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				if (isLeadByte(text[i]))
+				{
+					const style target = stops.empty()
+											 ? base
+											 : colored(position.next());
+					p = style::writeTransition(current, target, p);
+					current = target;
+				}
+				*p++ = text[i];
+			}
+			p = style::writeTransition(current, style(), p);
+			out.resize(start + static_cast<std::size_t>(p - begin));
+#endif
+		}
+
+		/**
+		 * Render text with this gradient.
+		 *
+		 * @param  text   UTF-8 text to render
+		 * @param  length Length of the text in bytes
+		 * @return        Rendered text, ending in the default rendition
+		 */
+		std::string render(const char * text, const std::size_t length) const
+		{
+			std::string result;
+			appendTo(result, text, length);
+			return result;
+		}
+
+		/**
+		 * Render text with this gradient.
+		 *
+		 * @param  text UTF-8 text to render
+		 * @return      Rendered text, ending in the default rendition
+		 */
+		std::string render(const std::string & text) const
+		{
+			return render(text.data(), text.size());
+		}
+
+	private:
+		/**
+		 * Walks evenly spaced steps along the color stops of a gradient,
+		 * advancing a 16.16 fixed point position without division.
+		 */
+		class cursor
+		{
+		public:
+			/**
+			 * @param stops Color stops, of which there is at least one
+			 * @param steps Number of steps to take from the first stop to
+			 *              the last
+			 */
+			cursor(const std::vector<rgb> & stops, const std::size_t steps) :
+				stops(stops.data()), segments(stops.size() - 1), position(0),
+				error(0), divisor(steps > 1 ? steps - 1 : 1),
+				quotient((std::uint64_t(segments) << 16) / divisor),
+				remainder((std::uint64_t(segments) << 16) % divisor)
+			{}
+
+			/**
+			 * @return Color of the current step, advancing to the next one
+			 */
+			rgb next()
+			{
+				std::uint64_t segment = position >> 16;
+				std::uint64_t fraction = position & 0xFFFF;
+				if (segment >= segments)
+				{
+					// The last step lies on the final stop
+					segment = segments == 0 ? 0 : segments - 1;
+					fraction = segments == 0 ? 0 : 0x10000;
+				}
+
+				const rgb & from = stops[segment];
+				const rgb & to = stops[segments == 0 ? 0 : segment + 1];
+				const rgb result = {
+					interpolate(from.r, to.r, static_cast<int>(fraction)),
+					interpolate(from.g, to.g, static_cast<int>(fraction)),
+					interpolate(from.b, to.b, static_cast<int>(fraction))};
+
+				position += quotient;
+				error += remainder;
+				if (error >= divisor)
+				{
+					error -= divisor;
+					++position;
+				}
+				return result;
+			}
+
+		private:
+			const rgb * stops;
+			std::uint64_t segments;
+			std::uint64_t position;
+			std::uint64_t error;
+			std::uint64_t divisor;
+			std::uint64_t quotient;
+			std::uint64_t remainder;
+
+			/**
+			 * @param  from     Component at the start of the segment
+			 * @param  to       Component at the end of the segment
+			 * @param  fraction Position within the segment, in [0,0x10000]
+			 * @return          Rounded interpolated component
+			 */
+			static std::uint8_t
+				interpolate(const int from, const int to, const int fraction)
+			{
+				return static_cast<std::uint8_t>(
+					((from << 16) + (to - from) * fraction + 0x8000) >> 16);
+			}
+		};
+
+		std::vector<rgb> stops;
+		style base;
+		ColorDepth depth;
+		bool foreground;
+
+		/**
+		 * @param  value Color of a character
+		 * @return       Rendition of the character
+		 */
+		style colored(const rgb & value) const
+		{
+			const std::uint32_t slot = style::rgbColor(value);
+			return style(base.attributeMask(),
+						 foreground ? slot : base.foregroundColor(),
+						 foreground ? base.backgroundColor() : slot)
+				.quantized(depth);
+		}
+
+		/**
+		 * @param  c Byte of UTF-8 text
+		 * @return   True if the byte starts a code point
+		 */
+		static bool isLeadByte(const char c)
+		{
+			return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+		}
+
+		/**
+		 * @param  text   UTF-8 text
+		 * @param  length Length of the text in bytes
+		 * @return        Number of code points in the text
+		 */
+		static std::size_t codePoints(const char * text,
+									  const std::size_t length)
+		{
+			std::size_t count = 0;
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				count += isLeadByte(text[i]) ? 1 : 0;
+			}
+			return count;
+		}
+	};
+CPP_SGR_END_NAMESPACE
+
+#endif /* end of include guard: CPP_SGR_GRADIENT_HPP */
@@ -0,0 +1,413 @@
+/**
+ *  cpp_sgr HTML conversion.
+ *
+ *  @file html.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_HTML_HPP
+#define CPP_SGR_HTML_HPP
+
+#include "parser.hpp"
+#include "core.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+CPP_SGR_BEGIN_NAMESPACE
+	namespace detail
+	{
+		/**
+		 * @param  c Character of text
+		 * @return   True if the character must be escaped in HTML
+		 */
+		inline bool is_html_special(const char c) noexcept
+		{
+			return c == '&' || c == '<' || c == '>' || c == '"' || c == '\'';
+		}
+
+		/**
+		 * Find the first character that must be escaped in HTML, comparing
+		 * 16 bytes at a time where SSE2 is available.
+		 *
+		 * @param  begin Start of the text
+		 * @param  end   End of the text
+		 * @return       Pointer to the first special character, or end
+		 */
+		inline const char * find_html_special(const char * begin,
+											  const char * end) noexcept
+		{
+#ifdef CPP_SGR_SSE2
+			const __m128i amp = _mm_set1_epi8('&');
+			const __m128i lt = _mm_set1_epi8('<');
+			const __m128i gt = _mm_set1_epi8('>');
+			const __m128i quot = _mm_set1_epi8('"');
+			const __m128i apos = _mm_set1_epi8('\'');
+			while (end - begin >= 16)
+			{
+				const __m128i chunk =
+					_mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+				const __m128i matches = _mm_or_si128(
+					_mm_or_si128(_mm_cmpeq_epi8(chunk, amp),
+								 _mm_cmpeq_epi8(chunk, lt)),
+					_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, gt),
+											  _mm_cmpeq_epi8(chunk, quot)),
+								 _mm_cmpeq_epi8(chunk, apos)));
+				const unsigned mask =
+					static_cast<unsigned>(_mm_movemask_epi8(matches));
+				if (mask)
+				{
+					return begin + lowest_bit(mask);
+				}
+				begin += 16;
+			}
+#endif
+			while (begin != end && !is_html_special(*begin))
+			{
+				++begin;
+			}
+			return begin;
+		}
+
+		/**
+		 * Append text to a std::string, escaping HTML special characters.
+		 * Spans without special characters are appended in bulk.
+		 *
+		 * @param out    std::string to append to
+		 * @param text   Text to escape
+		 * @param length Length of the text in bytes
+		 */
+		inline void append_html_escaped(std::string & out,
+										const char * text,
+										const std::size_t length)
+		{
+			const char * p = text;
+			const char * const end = text + length;
+			while (p != end)
+			{
+				const char * special = find_html_special(p, end);
+				out.append(p, static_cast<std::size_t>(special - p));
+				if (special == end)
+				{
+					break;
+				}
+				switch (*special)
+				{
+				case '&':
+					out.append("&amp;", 5);
+					break;
+				case '<':
+					out.append("&lt;", 4);
+					break;
+				case '>':
+					out.append("&gt;", 4);
+					break;
+				case '"':
+					out.append("&quot;", 6);
+					break;
+				default:
+					out.append("&#39;", 5);
+					break;
+				}
+				p = special + 1;
+			}
+		}
+
+		/**
+		 * Append a color as a CSS hexadecimal color, e.g. "#ff8000".
+		 *
+		 * @param out   std::string to append to
+		 * @param value Color to append
+		 */
+		inline void append_css_color(std::string & out, const rgb & value)
+		{
+			static const char digits[] = "0123456789abcdef";
+			const char text[7] = {'#',
+								  digits[value.r >> 4], digits[value.r & 15],
+								  digits[value.g >> 4], digits[value.g & 15],
+								  digits[value.b >> 4], digits[value.b & 15]};
+			out.append(text, 7);
+		}
+	}   // namespace detail
+
+	/**
+	 * Streaming converter from SGR-colored text to HTML.
+	 *
+	 * @class html_converter
+	 * Converts text chunk by chunk, appending HTML to a std::string the
+	 * caller may write out and clear between chunks, so memory use does not
+	 * grow with the input. Each run of text in a non-default rendition is
+	 * wrapped in a single span, which is only closed and reopened where the
+	 * rendition changes. Attributes and palette colors become classes
+	 * defined by stylesheet(); 24-bit colors are set inline. Escape
+	 * sequences other than SGRs are dropped, and HTML special characters are
+	 * escaped.
+	 */
+	class html_converter
+	{
+	public:
+		/**
+		 * Construct a converter starting in the default rendition.
+		 */
+		html_converter() : parser(), open(), spanOpen(false) {}
+
+		/**
+		 * Convert the next chunk of text.
+		 *
+		 * @param data   Chunk of SGR-colored text
+		 * @param length Length of the chunk in bytes
+		 * @param out    std::string the HTML is appended to
+		 */
+		void convert(const char * data,
+					 const std::size_t length,
+					 std::string & out)
+		{
+			parser.parse(data, length,
+						 [this, &out](const style & s,
+									  const char * text,
+									  const std::size_t count) {
+							 if (!spanOpen || s != open)
+							 {
+								 changeSpan(s, out);
+							 }
+							 detail::append_html_escaped(out, text, count);
+						 });
+		}
+
+		/**
+		 * Close the span left open at the end of the input, and return to the
+		 * default rendition for the next input.
+		 *
+		 * @param out std::string the HTML is appended to
+		 */
+		void finish(std::string & out)
+		{
+			if (spanOpen && !open.empty())
+			{
+				out.append("</span>", 7);
+			}
+			spanOpen = false;
+			open = style();
+			parser.reset();
+		}
+
+		/**
+		 * Generate the stylesheet defining the classes used by converted
+		 * HTML. Palette colors use xterm's default colors.
+		 *
+		 * @return CSS rules for all classes
+		 */
+		static std::string stylesheet()
+		{
+			std::string css =
+				".sgr-1{font-weight:bold}\n"
+				".sgr-2{opacity:0.7}\n"
+				".sgr-3{font-style:italic}\n"
+				".sgr-5,.sgr-6{animation:sgr-blink 1s step-end infinite}\n"
+				"@keyframes sgr-blink{50%{visibility:hidden}}\n"
+				".sgr-7{filter:invert(100%)}\n"
+				".sgr-8{visibility:hidden}\n"
+				".sgr-51{outline:1px solid}\n"
+				".sgr-52{border:1px solid;border-radius:0.5em}\n";
+
+			static const char * const lines[] = {"underline", "line-through",
+												 "overline"};
+			for (unsigned mask = 1; mask < 8; ++mask)
+			{
+				css += ".sgr-d" + std::to_string(mask) + "{text-decoration:";
+				for (unsigned bit = 0; bit < 3; ++bit)
+				{
+					if (mask & (1u << bit))
+					{
+						css += lines[bit];
+						css += ' ';
+					}
+				}
+				css.back() = '}';
+				css += '\n';
+			}
+
+			for (unsigned i = 0; i < 256; ++i)
+			{
+				css += ".sgr-fg" + std::to_string(i) + "{color:";
+				detail::append_css_color(css, detail::indexed_rgb(i));
+				css += "}\n.sgr-bg" + std::to_string(i) + "{background-color:";
+				detail::append_css_color(css, detail::indexed_rgb(i));
+				css += "}\n";
+			}
+			return css;
+		}
+
+	private:
+		sgr_parser parser;
+		style open;
+		bool spanOpen;
+
+		/**
+		 * Close the open span, if any, and open one for a new rendition
+		 * unless it is the default rendition.
+		 *
+		 * @param s   Rendition of the following text
+		 * @param out std::string the HTML is appended to
+		 */
+		void changeSpan(const style & s, std::string & out)
+		{
+			if (spanOpen && !open.empty())
+			{
+				out.append("</span>", 7);
+			}
+			open = s;
+			spanOpen = true;
+			if (s.empty())
+			{
+				return;
+			}
+
+			out.append("<span class=\"", 13);
+			const std::size_t classesStart = out.size();
+			static const int codes[] = {1, 2, 3, 5, 6, 7, 8, 51, 52};
+			for (const int code : codes)
+			{
+				if (s.has(code))
+				{
+					out.append(" sgr-", 5);
+					appendDecimal(out, static_cast<unsigned>(code));
+				}
+			}
+			const unsigned decorations = (s.has(4) ? 1u : 0u) |
+										 (s.has(9) ? 2u : 0u) |
+										 (s.has(53) ? 4u : 0u);
+			if (decorations)
+			{
+				out.append(" sgr-d", 6);
+				out += static_cast<char>('0' + decorations);
+			}
+			appendColorClass(out, s.foregroundColor(), " sgr-fg");
+			appendColorClass(out, s.backgroundColor(), " sgr-bg");
+			if (out.size() > classesStart)
+			{
+				// Drop the space before the first class
+				out.erase(classesStart, 1);
+			}
+			out += '"';
+
+			const bool rgbForeground =
+				style::colorKind(s.foregroundColor()) == style::RGB_COLOR;
+			const bool rgbBackground =
+				style::colorKind(s.backgroundColor()) == style::RGB_COLOR;
+			if (rgbForeground || rgbBackground)
+			{
+				out.append(" style=\"", 8);
+				if (rgbForeground)
+				{
+					out.append("color:", 6);
+					detail::append_css_color(out,
+											 slotColor(s.foregroundColor()));
+					out += ';';
+				}
+				if (rgbBackground)
+				{
+					out.append("background-color:", 17);
+					detail::append_css_color(out,
+											 slotColor(s.backgroundColor()));
+					out += ';';
+				}
+				out += '"';
+			}
+			out += '>';
+		}
+
+		/**
+		 * Append the class of a palette color, if the color slot holds one.
+		 *
+		 * @param out    std::string to append to
+		 * @param slot   Packed color slot
+		 * @param prefix Class name prefix, including the separating space
+		 */
+		static void appendColorClass(std::string & out,
+									 const std::uint32_t slot,
+									 const char * prefix)
+		{
+			unsigned index;
+			switch (style::colorKind(slot))
+			{
+			case style::ANSI_COLOR:
+				index = (slot & 0xFF) < 90 ? (slot & 0xFF) - 30
+										   : (slot & 0xFF) - 82;
+				break;
+			case style::INDEXED_COLOR:
+				index = slot & 0xFF;
+				break;
+			default:
+				return;
+			}
+			out += prefix;
+			appendDecimal(out, index);
+		}
+
+		/**
+		 * @param out   std::string to append to
+		 * @param value Value in the range [0,255] to append in decimal
+		 */
+		static void appendDecimal(std::string & out, const unsigned value)
+		{
+			char digits[3];
+			out.append(digits, detail::write_decimal(digits, value));
+		}
+
+		/**
+		 * @param  slot Packed color slot holding a 24-bit color
+		 * @return      The 24-bit color
+		 */
+		static rgb slotColor(const std::uint32_t slot)
+		{
+			return rgb{static_cast<std::uint8_t>(slot >> 16),
+					   static_cast<std::uint8_t>(slot >> 8),
+					   static_cast<std::uint8_t>(slot)};
+		}
+	};
+
+	/**
+	 * Convert SGR-colored text to HTML in one go.
+	 *
+	 * @param  text SGR-colored text
+	 * @return      HTML using the classes of html_converter::stylesheet()
+	 * @see html_converter
+	 */
+	inline std::string ansi_to_html(const std::string & text)
+	{
+		std::string result;
+		html_converter converter;
+		converter.convert(text.data(), text.size(), result);
+		converter.finish(result);
+		return result;
+	}
+CPP_SGR_END_NAMESPACE
+
+#endif /* end of include guard: CPP_SGR_HTML_HPP */
@@ -0,0 +1,857 @@
+/**
+ *  cpp_sgr std::ostream adapter.
+ *
+ *  @file ostream.hpp
+ */
+
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_OSTREAM_HPP
+#define CPP_SGR_OSTREAM_HPP
+
+#include "core.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <stdexcept>
+#endif
+
+CPP_SGR_BEGIN_NAMESPACE
+	namespace detail
+	{
+		/**
+		 * Indices of the std::ios_base storage slots used to remember the
+		 * terminal state of a stream.
+		 */
+		struct stream_slots
+		{
+			stream_slots() :
+				options(std::ios_base::xalloc()),
+				attributes(std::ios_base::xalloc()),
+				foreground(std::ios_base::xalloc()),
+				background(std::ios_base::xalloc())
+			{}
+
+			int options;
+			int attributes;
+			int foreground;
+			int background;
+		};
+
+		/**
+		 * @return Storage slot indices, allocated on first use
+		 */
+		inline const stream_slots & slots()
+		{
+			static const stream_slots indices;
+			return indices;
+		}
+
+		/**
+		 * Per-stream options, stored as bits of the options slot.
+		 */
+		enum stream_option : long
+		{
+			TRACK_STYLE = 1,
+			ATOMIC_CHAINS = 2,
+			COLOR_DEPTH = 7 << 8 /**< ColorDepth, shifted left by 8 bits */
+		};
+
+		/**
+		 * @param  stream Stream to query
+		 * @param  option Option to check
+		 * @return        True if the option is enabled on the stream
+		 */
+		inline bool has_option(std::ios_base & stream, const stream_option option)
+		{
+			return (stream.iword(slots().options) & option) != 0;
+		}
+
+		/**
+		 * @param stream Stream to modify
+		 * @param option Option to set
+		 * @param enable True to enable the option, false to disable it
+		 */
+		inline void set_option(std::ios_base & stream,
+							   const stream_option option,
+							   const bool enable)
+		{
+			long & options = stream.iword(slots().options);
+			options = enable ? (options | option) : (options & ~option);
+		}
+
+		/**
+		 * @param  stream Stream to query
+		 * @return        Color depth output to the stream is limited to
+		 */
+		inline ColorDepth load_depth(std::ios_base & stream)
+		{
+			return static_cast<ColorDepth>(
+				(stream.iword(slots().options) & COLOR_DEPTH) >> 8);
+		}
+
+		/**
+		 * @param  stream Stream to query
+		 * @return        Rendition last recorded for the stream
+		 */
+		inline style load_style(std::ios_base & stream)
+		{
+			const stream_slots & indices = slots();
+			return style(
+				static_cast<std::uint16_t>(stream.iword(indices.attributes)),
+				static_cast<std::uint32_t>(stream.iword(indices.foreground)),
+				static_cast<std::uint32_t>(stream.iword(indices.background)));
+		}
+
+		/**
+		 * @param stream Stream to modify
+		 * @param s      Rendition now in effect on the stream
+		 */
+		inline void store_style(std::ios_base & stream, const style & s)
+		{
+			const stream_slots & indices = slots();
+			stream.iword(indices.attributes) = s.attributeMask();
+			stream.iword(indices.foreground) =
+				static_cast<long>(s.foregroundColor());
+			stream.iword(indices.background) =
+				static_cast<long>(s.backgroundColor());
+		}
+
+		/**
+		 * Growable std::streambuf staging the output of an insertion chain.
+		 * Its storage is kept between chains, so staging does not allocate
+		 * once it has grown to the size of the largest chain.
+		 */
+		class staging_buffer : public std::streambuf
+		{
+		public:
+			staging_buffer() : storage(256) { clear(); }
+
+			/**
+			 * @return Pointer to the staged bytes
+			 */
+			const char * data() const { return pbase(); }
+
+			/**
+			 * @return Number of staged bytes
+			 */
+			std::size_t size() const
+			{
+				return static_cast<std::size_t>(pptr() - pbase());
+			}
+
+			/**
+			 * Discard the staged bytes, keeping the storage.
+			 */
+			void clear()
+			{
+				setp(storage.data(), storage.data() + storage.size());
+			}
+
+		protected:
+			int_type overflow(const int_type c) override
+			{
+				if (traits_type::eq_int_type(c, traits_type::eof()))
+				{
+					return traits_type::not_eof(c);
+				}
+				reserve(1);
+				*pptr() = traits_type::to_char_type(c);
+				pbump(1);
+				return c;
+			}
+
+			std::streamsize xsputn(const char * data,
+								   const std::streamsize count) override
+			{
+				const std::size_t length = static_cast<std::size_t>(count);
+				reserve(length);
+				std::memcpy(pptr(), data, length);
+				pbump(static_cast<int>(count));
+				return count;
+			}
+
+		private:
+			/**
+			 * Ensure room for the given number of additional bytes.
+			 *
+			 * @param extra Number of bytes to make room for
+			 */
+			void reserve(const std::size_t extra)
+			{
+				const std::size_t used = size();
+				if (storage.size() - used >= extra)
+				{
+					return;
+				}
+				storage.resize(std::max(storage.size() * 2, used + extra));
+				clear();
+				pbump(static_cast<int>(used));
+			}
+
+			std::vector<char> storage;
+		};
+
+		/**
+		 * Per-thread stage for atomic insertion chains.
+		 */
+		struct chain_stage
+		{
+			chain_stage() : stream(&buffer), busy(false) {}
+
+			staging_buffer buffer;
+			std::ostream stream;
+			bool busy;
+		};
+
+		/**
+		 * Claim the calling thread's stage for a chain inserting into the
+		 * given stream, if the stream has atomic chains enabled and the stage
+		 * is not already used by an enclosing chain.
+		 *
+		 * @param  target Stream the chain inserts into
+		 * @return        Stage carrying the formatting state of the stream,
+		 * or null if the chain should write to the stream directly
+		 */
+		inline chain_stage * acquire_stage(std::ostream & target)
+		{
+			if (!has_option(target, ATOMIC_CHAINS))
+			{
+				return nullptr;
+			}
+
+			static thread_local chain_stage stage;
+			if (stage.busy)
+			{
+				return nullptr;
+			}
+
+			stage.busy = true;
+			stage.buffer.clear();
+			stage.stream.clear();
+			stage.stream.flags(target.flags());
+			stage.stream.precision(target.precision());
+			stage.stream.width(target.width());
+			stage.stream.fill(target.fill());
+			if (stage.stream.getloc() != target.getloc())
+			{
+				stage.stream.imbue(target.getloc());
+			}
+			return &stage;
+		}
+	}   // namespace detail
+
+	/**
+	 * Enable or disable tracking of the terminal rendition of a stream.
+	 *
+	 * When tracking is enabled, the stream remembers the rendition left in
+	 * effect by sgr insertions. Each insertion then writes only the shortest
+	 * transition from that rendition, or nothing if it is unchanged, and
+	 * insertion chains no longer reset when they end; the next chain picks up
+	 * from the remembered rendition instead. As a consequence, text inserted
+	 * outside of a chain is rendered in whatever rendition is left in effect,
+	 * so insert cpp_sgr::reset or disable tracking before writing unstyled
+	 * text. Disabling tracking resets the stream if needed.
+	 *
+	 * Tracking state is kept in the stream's std::ios_base storage, so it is
+	 * not synchronized; a tracked stream must not be written to by several
+	 * threads at once.
+	 *
+	 * @param stream Stream to configure
+	 * @param enable True to enable tracking, false to disable it
+	 */
+	inline void track_style(std::ostream & stream, const bool enable = true)
+	{
+		if (!enable && !detail::load_style(stream).empty())
+		{
+			static const char resetSequence[] = "\033[0m";
+			if (!stream.rdbuf() ||
+				stream.rdbuf()->sputn(resetSequence, 4) != 4)
+			{
+				stream.setstate(std::ios_base::badbit);
+			}
+		}
+
+		detail::store_style(stream, style());
+		detail::set_option(stream, detail::TRACK_STYLE, enable);
+	}
+
+	/**
+	 * Enable or disable atomic insertion chains on a stream.
+	 *
+	 * When enabled, everything an insertion chain writes, including its
+	 * final reset, is staged in a buffer owned by the calling thread and
+	 * committed to the stream's std::streambuf with a single sputn() call
+	 * when the chain ends. Concurrent chains then cannot interleave their
+	 * escape sequences and text, provided the std::streambuf handles
+	 * concurrent sputn() calls atomically, as the standard streams
+	 * synchronized with stdio do. The staging buffer is reused across
+	 * chains, so no allocation takes place in steady state.
+	 *
+	 * Atomic chains always start from and end in the default rendition;
+	 * style tracking (see track_style()) does not apply to them. Enable this
+	 * before the stream is shared between threads.
+	 *
+	 * @param stream Stream to configure
+	 * @param enable True to enable atomic chains, false to disable them
+	 */
+	inline void atomic_chains(std::ostream & stream, const bool enable = true)
+	{
+		detail::set_option(stream, detail::ATOMIC_CHAINS, enable);
+
+		// Querying the fill character may initialize it; do so while the
+		// stream is not yet shared
+		stream.fill();
+	}
+
+	/**
+	 * Limit the colors written to a stream to a color depth.
+	 *
+	 * Colors of sgrs inserted into the stream that lie beyond the depth are
+	 * replaced by the perceptually nearest colors within it, e.g. 24-bit
+	 * colors become xterm 256 palette entries for INDEXED_256. Each
+	 * replacement costs a table lookup. The default depth is TRUECOLOR,
+	 * which writes all colors unchanged. With PLAIN, insertion chains write
+	 * no escape sequences at all.
+	 *
+	 * @param stream Stream to configure
+	 * @param depth  Color depth of the terminal the stream writes to
+	 */
+	inline void color_depth(std::ostream & stream, const ColorDepth depth)
+	{
+		long & options = stream.iword(detail::slots().options);
+		options = (options & ~long(detail::COLOR_DEPTH)) | long(depth) << 8;
+	}
+
+	/**
+	 * Wrapper for std::ostream that automatically clears SGRs when disposed
+	 *
+	 * @class sgr_ostream_wrapper
+	 * This class wraps std::ostream for SGR management; upon destruction,
+	 * it inserts the reset SGR into its underlying stream. Thus the user is
+	 * relieved of the need to explicitly clear SGRs from streams. For typical
+	 * usage, the wrapper is destroyed at the end of a series of stream
+	 * insertions, so the SGR will be cleared after a single chain of
+	 * insertions.
+	 *
+	 * The wrapper does not construct a stream of its own. Escape sequences are
+	 * written straight into the stream's std::streambuf, and other values are
+	 * inserted through the original stream, so formatting state set before the
+	 * chain (e.g. std::hex, std::setw, std::setfill) carries over into it.
+	 * Formatting flags, fill and precision changed within the chain are
+	 * restored when the wrapper is destroyed.
+	 *
+	 * If the stream tracks its rendition (see track_style()), the wrapper
+	 * writes only the transitions between renditions and records the final
+	 * rendition instead of resetting. If the stream has atomic chains enabled
+	 * (see atomic_chains()), the wrapper stages all output and commits it
+	 * with a single write when destroyed. If the stream has a limited color
+	 * depth (see color_depth()), the wrapper writes the transitions between
+	 * the quantized renditions of the chain.
+	 */
+
+	class sgr_ostream_wrapper
+	{
+	public:
+		/**
+		 * Construct an sgr_ostream_wrapper writing to the provided
+		 * std::ostream, recording its formatting state.
+		 *
+		 * @param stream Stream to be wrapped
+		 */
+		sgr_ostream_wrapper(std::ostream & stream) :
+			origin(&stream), stage(detail::acquire_stage(stream)),
+			stream(stage ? &stage->stream : &stream),
+			buffer(this->stream->rdbuf()), flags(stream.flags()),
+			precision(stream.precision()), fill(stream.fill()),
+			tracked(!stage && detail::has_option(stream, detail::TRACK_STYLE)),
+			depth(detail::load_depth(stream)),
+			incremental(tracked || depth != TRUECOLOR),
+			current(tracked ? detail::load_style(stream) : style()),
+			started(false), shouldReset(true)
+		{}
+
+		/**
+		 * Construct an sgr_ostream_wrapper by taking over the other wrapper's
+		 * stream and assuming reset responsibility.
+		 *
+		 * @param other Wrapper to be moved
+		 */
+		sgr_ostream_wrapper(sgr_ostream_wrapper && other) noexcept :
+			origin(other.origin), stage(other.stage), stream(other.stream),
+			buffer(other.buffer), flags(other.flags),
+			precision(other.precision), fill(other.fill),
+			tracked(other.tracked), depth(other.depth),
+			incremental(other.incremental), current(other.current),
+			started(other.started), shouldReset(other.shouldReset)
+		{
+			other.shouldReset = false;
+		}
+
+		sgr_ostream_wrapper(const sgr_ostream_wrapper & other) = delete;
+
+		/**
+		 * Destructor that inserts a reset SGR into the stream if necessary.
+		 */
+		~sgr_ostream_wrapper() { this->kill(); }
+
+		/**
+		 * Insert the given argument into the underlying std::ostream. T must
+		 * overload operator<<.
+		 *
+		 * @param t Object to insert into stream
+		 * @typeparam T Type of object to insert; must overload operator<<.
+		 * @return Reference to this wrapper
+		 */
+		template<class T,
+				 typename std::enable_if<!std::is_base_of<sgr, T>::value,
+										 int>::type = 0>
+		sgr_ostream_wrapper & operator<<(const T & t)
+		{
+			*stream << t;
+			return *this;
+		}
+
+		/**
+		 * Insert the given sgr into the underlying std::streambuf. The escape
+		 * sequence is rendered into an inline buffer and written without
+		 * allocating.
+		 *
+		 * @param s sgr to insert into stream
+		 * @return Reference to this wrapper
+		 */
+		sgr_ostream_wrapper & operator<<(const sgr & s)
+		{
+			if (incremental)
+			{
+				transition(base().merge(s.getStyle()).effective());
+			}
+			else
+			{
+				const rendered_style bytes = s.render();
+				write(bytes.data(), bytes.size());
+			}
+			return *this;
+		}
+
+		/**
+		 * Insert the given compile-time SGR into the underlying
+		 * std::streambuf.
+		 *
+		 * @param s static_sgr to insert into stream
+		 * @return Reference to this wrapper
+		 */
+		template<int... Params>
+		sgr_ostream_wrapper & operator<<(const static_sgr<Params...> & s)
+		{
+			if (incremental)
+			{
+				const int params[] = {Params..., 0};
+				transition(base().applyParams(params, sizeof...(Params)));
+			}
+			else
+			{
+				write(s.c_str(), s.size());
+			}
+			return *this;
+		}
+
+	private:
+		std::ostream * origin;
+		detail::chain_stage * stage;
+		std::ostream * stream;
+		std::streambuf * buffer;
+
+		std::ios_base::fmtflags flags;
+		std::streamsize precision;
+		char fill;
+
+		bool tracked;
+		ColorDepth depth;
+		bool incremental;
+		style current;
+		bool started;
+
+		bool shouldReset = true;
+
+		/**
+		 * Retrieve the rendition the next sgr insertion applies to. Every
+		 * chain starts out from the default rendition, even if a tracked
+		 * stream still has another one in effect.
+		 *
+		 * @return Rendition to apply the next sgr to
+		 */
+		style base() const { return started ? current : style(); }
+
+		/**
+		 * Write the transition from the current rendition to another one, fit
+		 * into the stream's color depth, and make it current.
+		 *
+		 * @param target Rendition to change to
+		 */
+		void transition(style target)
+		{
+			target = target.quantized(depth);
+			char bytes[style::MAX_TRANSITION_SIZE];
+			const char * end = style::writeTransition(current, target, bytes);
+			write(bytes, static_cast<std::size_t>(end - bytes));
+			current = target;
+			started = true;
+		}
+
+		/**
+		 * Write raw bytes into the underlying std::streambuf, marking the
+		 * stream bad if they cannot all be written.
+		 *
+		 * @param data  Bytes to write
+		 * @param count Number of bytes to write
+		 */
+		void write(const char * data, const std::size_t count)
+		{
+			const std::streamsize size = static_cast<std::streamsize>(count);
+			if (!buffer || buffer->sputn(data, size) != size)
+			{
+				stream->setstate(std::ios_base::badbit);
+			}
+		}
+
+		/**
+		 * Write the staged chain into the original stream's std::streambuf
+		 * with a single call, and release the stage.
+		 */
+		void commit()
+		{
+			std::streambuf * target = origin->rdbuf();
+			const std::streamsize size =
+				static_cast<std::streamsize>(stage->buffer.size());
+			if (!target || target->sputn(stage->buffer.data(), size) != size)
+			{
+				origin->setstate(std::ios_base::badbit);
+			}
+			if (!stage->stream.good())
+			{
+				origin->setstate(stage->stream.rdstate());
+			}
+			if (origin->width() != stage->stream.width())
+			{
+				origin->width(stage->stream.width());
+			}
+			stage->busy = false;
+		}
+
+		/**
+		 * Mark this stream as having been reset, insert a reset sgr (or record
+		 * the current rendition if tracked) if needed, and restore the
+		 * stream's formatting state or commit the staged chain.
+		 */
+		void kill()
+		{
+			if (shouldReset)
+			{
+				shouldReset = false;
+				if (tracked)
+				{
+					detail::store_style(*origin, current);
+				}
+				else if (depth != PLAIN)
+				{
+					const static_sgr<sgr::RESET> resetSequence;
+					write(resetSequence.c_str(), resetSequence.size());
+				}
+
+				if (stage)
+				{
+					commit();
+				}
+				else
+				{
+					origin->flags(flags);
+					origin->precision(precision);
+					origin->fill(fill);
+				}
+				if ((flags & std::ios_base::unitbuf) && origin->rdbuf())
+				{
+					origin->rdbuf()->pubsync();
+				}
+			}
+		}
+	};
+
+#ifdef CPP_SGR_DISABLE
+	/**
+	 * Insert an sgr into a std::ostream. With CPP_SGR_DISABLE defined, this
+	 * does nothing, and the chain continues on the std::ostream itself.
+	 *
+	 * @param  out std::ostream to insert into
+	 * @return     The given std::ostream
+	 */
+	inline std::ostream & operator<<(std::ostream & out, const sgr &)
+	{
+		return out;
+	}
+
+	/**
+	 * Insert a compile-time SGR into a std::ostream. With CPP_SGR_DISABLE
+	 * defined, this does nothing, and the chain continues on the
+	 * std::ostream itself.
+	 *
+	 * @param  out std::ostream to insert into
+	 * @return     The given std::ostream
+	 */
+	template<int... Params>
+	std::ostream & operator<<(std::ostream & out, const static_sgr<Params...> &)
+	{
+		return out;
+	}
+#else
+	/**
+	 * Insert an sgr into a std::ostream, setting the active sgr.
+	 * This operation returns an sgr_ostream_wrapper, which will automatically
+	 * clear the active sgr when the stream being inserted into is destroyed.
+	 * The returned wrapper writes into the std::ostream inserted into.
+	 *
+	 * @param  out std::ostream to insert into
+	 * @param  c   sgr to insert
+	 * @return     sgr_ostream replacing the std::ostream
+	 */
+	inline sgr_ostream_wrapper operator<<(std::ostream & out, const sgr & c)
+	{
+		sgr_ostream_wrapper wrapper(out);
+		wrapper << c;
+		return wrapper;
+	}
+
+	/**
+	 * Insert a compile-time SGR into a std::ostream, setting the active sgr.
+	 * Behaves like insertion of an sgr, but writes the precomputed escape
+	 * sequence without any runtime formatting.
+	 *
+	 * @param  out std::ostream to insert into
+	 * @param  s   static_sgr to insert
+	 * @return     sgr_ostream replacing the std::ostream
+	 * @see operator<<(std::ostream & out, const sgr & c)
+	 */
+	template<int... Params>
+	sgr_ostream_wrapper operator<<(std::ostream & out,
+								   const static_sgr<Params...> & s)
+	{
+		sgr_ostream_wrapper wrapper(out);
+		wrapper << s;
+		return wrapper;
+	}
+#endif
+
+	namespace detail
+	{
+		/**
+		 * Visitor inserting each value it is called with into a stream.
+		 */
+		template<class Stream>
+		struct value_inserter
+		{
+			Stream & out;
+
+			template<class T>
+			void operator()(const T & value)
+			{
+				out << value;
+			}
+		};
+
+		/**
+		 * Write raw bytes into a stream's std::streambuf, marking the stream
+		 * bad if they cannot all be written.
+		 *
+		 * @param out   Stream to write to
+		 * @param data  Bytes to write
+		 * @param count Number of bytes to write
+		 */
+		inline void write_raw(std::ostream & out,
+							  const char * data,
+							  const std::size_t count)
+		{
+			const std::streamsize size = static_cast<std::streamsize>(count);
+			std::streambuf * buffer = out.rdbuf();
+			if (!buffer || buffer->sputn(data, size) != size)
+			{
+				out.setstate(std::ios_base::badbit);
+			}
+		}
+
+		/**
+		 * Insert values rendered in a style into a stream. Unless the stream
+		 * tracks its style or has atomic chains enabled, the escape sequence
+		 * and reset are written straight into its std::streambuf around the
+		 * values, which are inserted into the stream itself, so its
+		 * formatting state applies to them as usual. Otherwise the insertion
+		 * goes through an sgr_ostream_wrapper like a chain would. Atomic
+		 * chains take precedence over tracking, as for any chain: on a stream
+		 * with both enabled, the values end in the default rendition.
+		 *
+		 * @param  out    Stream to insert into
+		 * @param  s      Style to render the values in
+		 * @param  values Object whose forEach() visits the values
+		 * @return        The given stream
+		 */
+		template<class Values>
+		std::ostream & insert_styled(std::ostream & out,
+									 const style & s,
+									 const Values & values)
+		{
+#ifndef CPP_SGR_DISABLE
+			if (has_option(out, TRACK_STYLE) || has_option(out, ATOMIC_CHAINS))
+			{
+				// A tracked stream returns to the rendition it had before the
+				// values; atomic chains reset anyway
+				const bool restore = !has_option(out, ATOMIC_CHAINS);
+				const style previous = restore ? load_style(out) : style();
+				sgr_ostream_wrapper wrapper(out);
+				wrapper << sgr(s);
+				value_inserter<sgr_ostream_wrapper> inserter{wrapper};
+				values.forEach(inserter);
+				if (restore)
+				{
+					wrapper << (reset + sgr(previous));
+				}
+				return out;
+			}
+
+			const style target = s.effective().quantized(load_depth(out));
+			if (!target.empty())
+			{
+				using reset_sequence = static_sgr<sgr::RESET>;
+				const rendered_style prefix = target.render();
+				write_raw(out, prefix.data(), prefix.size());
+				value_inserter<std::ostream> inserter{out};
+				values.forEach(inserter);
+				write_raw(out, reset_sequence::c_str(), reset_sequence::size());
+				if ((out.flags() & std::ios_base::unitbuf) && out.rdbuf())
+				{
+					out.rdbuf()->pubsync();
+				}
+				return out;
+			}
+#else
+			static_cast<void>(s);
+#endif
+			value_inserter<std::ostream> inserter{out};
+			values.forEach(inserter);
+			return out;
+		}
+
+		/**
+		 * Adapter giving a single styled value the forEach() of a list.
+		 */
+		template<class T>
+		struct single_value
+		{
+			const T & value;
+
+			template<class Visitor>
+			void forEach(Visitor & visitor) const
+			{
+				visitor(value);
+			}
+		};
+	}   // namespace detail
+
+	/**
+	 * Insert a value rendered in a style into a std::ostream. The escape
+	 * sequence, the value and a reset are written through the stream itself,
+	 * without constructing an sgr_ostream_wrapper, so the stream's formatting
+	 * state, including its width, applies to the value alone. Streams
+	 * tracking their style or with atomic chains enabled behave as if the
+	 * style and value were inserted as a chain; a tracked stream then returns
+	 * to the rendition it had before the value, unless atomic chains are
+	 * also enabled, in which case the value ends in the default rendition.
+	 *
+	 * @param  out   std::ostream to insert into
+	 * @param  value styled_value returned by styled()
+	 * @return       The given std::ostream
+	 */
+	template<class T>
+	std::ostream & operator<<(std::ostream & out, const styled_value<T> & value)
+	{
+		const detail::single_value<T> values{value.getValue()};
+		return detail::insert_styled(out, value.getStyle(), values);
+	}
+
+	/**
+	 * Insert several values sharing one style into a std::ostream, writing
+	 * the escape sequence once before them and one reset after them.
+	 *
+	 * @param  out    std::ostream to insert into
+	 * @param  values styled_values returned by styled()
+	 * @return        The given std::ostream
+	 * @see operator<<(std::ostream & out, const styled_value<T> & value)
+	 */
+	template<class... Values>
+	std::ostream & operator<<(std::ostream & out,
+							  const styled_values<Values...> & values)
+	{
+		return detail::insert_styled(out, values.getStyle(), values);
+	}
+
+#ifdef _WIN32
+	/**
+	 * Enables virtual terminal command processing on Windows. This allows
+	 * the use of SGRs in cmd.exe.
+	 *
+	 * @throw std::runtime_error if enabling virtual terminal command processing
+	 * fails for any reason.
+	 */
+	inline void enable_vterm_processing()
+	{
+		HANDLE stdOutHandle = GetStdHandle(STD_OUTPUT_HANDLE);
+
+		if (stdOutHandle == INVALID_HANDLE_VALUE)
+		{
+			throw std::runtime_error("Failed to get stdout handle");
+		}
+
+		DWORD consoleMode = 0;
+		if (!GetConsoleMode(stdOutHandle, &consoleMode))
+		{
+			throw std::runtime_error("Failed to get console mode");
+		}
+
+		consoleMode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING;
+		if (!SetConsoleMode(stdOutHandle, consoleMode))
+		{
+			throw std::runtime_error("Failed to set console mode");
+		}
+	}
+#endif
+CPP_SGR_END_NAMESPACE
+
+#endif /* end of include guard: CPP_SGR_OSTREAM_HPP */
@@ -0,0 +1,307 @@
+/**
+ *  cpp_sgr escape sequence parser.
+ *
+ *  @file parser.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_PARSER_HPP
+#define CPP_SGR_PARSER_HPP
+
+#include "core.hpp"
+#include "strip.hpp"
+
+#include <cstddef>
+
+CPP_SGR_BEGIN_NAMESPACE
+	/**
+	 * Incremental parser splitting terminal output into runs of text and
+	 * the style they are rendered in.
+	 *
+	 * @class sgr_parser
+	 * The parser consumes chunks of bytes and passes every run of text
+	 * between escape sequences to a callback, together with the rendition in
+	 * effect, as a terminal would display it. SGR sequences update the
+	 * rendition; all other escape sequences (other CSI sequences, string
+	 * commands such as OSC, and two-byte escapes) are dropped. Runs point
+	 * into the chunk being parsed, so nothing is copied or allocated; a run
+	 * spanning several chunks is reported once per chunk.
+	 *
+	 * Colon-separated sub-parameters are read as a group, so both the
+	 * ITU T.416 forms of extended colors, e.g. 38:2::R:G:B or 38:2:CS:R:G:B,
+	 * and the common 38;2;R;G;B form are understood. Sub-parameters of other
+	 * attributes are ignored, except that 4:0 turns underlining off.
+	 *
+	 * The parser's state is a fixed size: parameters beyond MAX_PARAMS in
+	 * one sequence and sub-parameters beyond MAX_SUBPARAMS in one group are
+	 * ignored, and parameter values saturate at 65535.
+	 */
+	class sgr_parser
+	{
+	public:
+		enum : std::size_t
+		{
+			/**
+			 * Maximum number of parameters of a sequence that are applied.
+			 */
+			MAX_PARAMS = 32,
+
+			/**
+			 * Maximum number of colon-separated sub-parameters of one
+			 * parameter that are read.
+			 */
+			MAX_SUBPARAMS = 6
+		};
+
+		/**
+		 * Construct a parser starting in the default rendition.
+		 */
+		sgr_parser() noexcept :
+			selecting(false), count(0), subcount(0), value(0), current()
+		{
+		}
+
+		/**
+		 * Parse the next chunk of bytes.
+		 *
+		 * @param data     Chunk of bytes
+		 * @param length   Length of the chunk in bytes
+		 * @param callback Called as callback(const style &, const char *,
+		 *                 std::size_t) with every non-empty run of text and
+		 *                 the rendition it is displayed in
+		 * @typeparam Callback Type of the callback
+		 */
+		template<class Callback>
+		void parse(const char * data,
+				   const std::size_t length,
+				   Callback && callback)
+		{
+			const char * p = data;
+			const char * const end = data + length;
+			while (p != end)
+			{
+				if (!tokenizer.pending())
+				{
+					const char * escape = detail::find_escape(p, end);
+					if (escape != p)
+					{
+						callback(static_cast<const style &>(current), p,
+								 static_cast<std::size_t>(escape - p));
+					}
+					if (escape == end)
+					{
+						break;
+					}
+					tokenizer.start();
+					p = escape + 1;
+					continue;
+				}
+
+				if (!consume(*p))
+				{
+					callback(static_cast<const style &>(current), p,
+							 std::size_t(1));
+				}
+				++p;
+			}
+		}
+
+		/**
+		 * @return Rendition in effect after the bytes parsed so far
+		 */
+		const style & getStyle() const noexcept { return current; }
+
+		/**
+		 * @return True if the last chunk ended inside an escape sequence
+		 */
+		bool pending() const noexcept { return tokenizer.pending(); }
+
+		/**
+		 * Return to the default rendition and forget any partial escape
+		 * sequence.
+		 */
+		void reset() noexcept
+		{
+			tokenizer.reset();
+			selecting = false;
+			count = 0;
+			subcount = 0;
+			value = 0;
+			current = style();
+		}
+
+	private:
+		detail::escape_tokenizer tokenizer;
+		bool selecting;
+		std::size_t count;
+		std::size_t subcount;
+		int value;
+		int params[MAX_PARAMS];
+		int subparams[MAX_SUBPARAMS];
+		style current;
+
+		/**
+		 * Advance the state machine by one byte following an ESC, reading
+		 * the parameters of SGR sequences.
+		 *
+		 * @param  c Byte to consume
+		 * @return   True if the byte belongs to an escape sequence, false if
+		 *           it aborted the sequence and is text
+		 */
+		bool consume(const char c) noexcept
+		{
+			switch (tokenizer.consume(c))
+			{
+			case detail::escape_tokenizer::TEXT_BYTE:
+				return false;
+			case detail::escape_tokenizer::CSI_START:
+				selecting = true;
+				count = 0;
+				subcount = 0;
+				value = 0;
+				break;
+			case detail::escape_tokenizer::CSI_PARAMETER:
+				if (selecting)
+				{
+					parameterByte(c);
+				}
+				break;
+			case detail::escape_tokenizer::CSI_FINAL:
+				if (selecting && c == 'm')
+				{
+					push();
+					current = current.applyParams(params, count);
+				}
+				selecting = false;
+				break;
+			case detail::escape_tokenizer::SEQUENCE_BYTE:
+				selecting = false;
+				break;
+			}
+			return true;
+		}
+
+		/**
+		 * Read a parameter or intermediate byte of a CSI sequence.
+		 *
+		 * @param c Byte to read
+		 */
+		void parameterByte(const char c) noexcept
+		{
+			if (c >= '0' && c <= '9')
+			{
+				value = value < 6553 ? value * 10 + (c - '0') : 65535;
+			}
+			else if (c == ':')
+			{
+				pushSubparam();
+			}
+			else if (c == ';')
+			{
+				push();
+			}
+			else
+			{
+				// Private parameters and intermediates make this another
+				// kind of sequence
+				selecting = false;
+			}
+		}
+
+		/**
+		 * Store a parameter, unless there are too many.
+		 *
+		 * @param param Parameter to store
+		 */
+		void append(const int param) noexcept
+		{
+			if (count < MAX_PARAMS)
+			{
+				params[count++] = param;
+			}
+		}
+
+		/**
+		 * Store the sub-parameter read so far, unless there are too many.
+		 */
+		void pushSubparam() noexcept
+		{
+			if (subcount < MAX_SUBPARAMS)
+			{
+				subparams[subcount++] = value;
+			}
+			value = 0;
+		}
+
+		/**
+		 * Store the parameter read so far. A group of sub-parameters is
+		 * stored as the equivalent semicolon-separated parameters.
+		 */
+		void push() noexcept
+		{
+			if (subcount == 0)
+			{
+				append(value);
+				value = 0;
+				return;
+			}
+
+			pushSubparam();
+			const int code = subparams[0];
+			if ((code == 38 || code == 48) && subcount >= 3 &&
+				subparams[1] == 5)
+			{
+				append(code);
+				append(5);
+				append(subparams[2]);
+			}
+			else if ((code == 38 || code == 48) && subcount >= 5 &&
+					 subparams[1] == 2)
+			{
+				// The color space identifier before R is optional
+				const std::size_t first = subcount >= 6 ? 3 : 2;
+				append(code);
+				append(2);
+				append(subparams[first]);
+				append(subparams[first + 1]);
+				append(subparams[first + 2]);
+			}
+			else if (code == 4 && subparams[1] == 0)
+			{
+				append(24);
+			}
+			else if (code != 38 && code != 48)
+			{
+				append(code);
+			}
+			subcount = 0;
+		}
+	};
+CPP_SGR_END_NAMESPACE
+
+#endif /* end of include guard: CPP_SGR_PARSER_HPP */
@@ -0,0 +1,272 @@
+/**
+ *  cpp_sgr style registry.
+ *
+ *  @file registry.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_REGISTRY_HPP
+#define CPP_SGR_REGISTRY_HPP
+
+#include "core.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <unordered_map>
+
+CPP_SGR_BEGIN_NAMESPACE
+	/**
+	 * Exception indicating a style_registry has no room for another style.
+	 *
+	 * @class style_registry_full
+	 */
+	struct style_registry_full : public std::exception
+	{
+		/**
+		 * Returns a text description of the error causing this exception.
+		 *
+		 * @return description of the error causing this exception
+		 */
+		const char * what() const throw()
+		{
+			return "intern more than 65536 styles in a style_registry";
+		}
+	};
+
+	/**
+	 * Registry interning styles under compact 16-bit ids.
+	 *
+	 * @class style_registry
+	 * Each distinct style is stored once, together with its pre-rendered
+	 * escape sequence, so log records or screen cells can refer to a style
+	 * with a 2-byte id. The escape sequences are packed back to back in
+	 * blocks of 256 styles. Looking up an id never locks and may run
+	 * concurrently with interning; interning a style takes a lock.
+	 *
+	 * Id 0 always refers to the empty style.
+	 */
+	class style_registry
+	{
+	public:
+		enum : std::size_t
+		{
+			/**
+			 * Maximum number of styles a registry can hold.
+			 */
+			CAPACITY = 65536
+		};
+
+		/**
+		 * Construct a registry holding only the empty style.
+		 */
+		style_registry() : count(0)
+		{
+			for (std::atomic<block *> & b : blocks)
+			{
+				b.store(nullptr, std::memory_order_relaxed);
+			}
+			intern(style());
+		}
+
+		style_registry(const style_registry &) = delete;
+		style_registry & operator=(const style_registry &) = delete;
+
+		/**
+		 * Destroy the registry, invalidating all pointers into it.
+		 */
+		~style_registry()
+		{
+			for (std::atomic<block *> & b : blocks)
+			{
+				delete b.load(std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		 * @return Registry shared by the whole process
+		 */
+		static style_registry & global()
+		{
+			static style_registry registry;
+			return registry;
+		}
+
+		/**
+		 * Retrieve the id of a style, registering it if it is new.
+		 *
+		 * @param  s style to intern
+		 * @return   Id of the style
+		 * @throw style_registry_full if the style is new and the registry
+		 * already holds CAPACITY styles
+		 */
+		std::uint16_t intern(const style & s)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			const auto found = ids.find(s);
+			if (found != ids.end())
+			{
+				return found->second;
+			}
+
+			const std::size_t id = count.load(std::memory_order_relaxed);
+			if (id >= CAPACITY)
+			{
+				throw style_registry_full();
+			}
+
+			block * b = blocks[id >> 8].load(std::memory_order_relaxed);
+			if (!b)
+			{
+				b = new block();
+				blocks[id >> 8].store(b, std::memory_order_release);
+			}
+			entry & e = b->entries[id & 0xFF];
+			e.value = s;
+			e.offset = static_cast<std::uint16_t>(b->used);
+			e.length = static_cast<std::uint8_t>(
+				s.writeTo(b->bytes + b->used) - (b->bytes + b->used));
+			b->used += e.length;
+
+			ids.emplace(s, static_cast<std::uint16_t>(id));
+			count.store(id + 1, std::memory_order_release);
+			return static_cast<std::uint16_t>(id);
+		}
+
+		/**
+		 * Retrieve the id of an sgr's style, registering it if it is new.
+		 *
+		 * @param  s sgr whose style to intern
+		 * @return   Id of the style
+		 * @see intern(const style &)
+		 */
+		std::uint16_t intern(const sgr & s) { return intern(s.getStyle()); }
+
+		/**
+		 * Retrieve an interned style. Does not lock.
+		 *
+		 * @param  id Id returned by intern()
+		 * @return    The style registered under the id
+		 */
+		const style & getStyle(const std::uint16_t id) const noexcept
+		{
+			return lookup(id).value;
+		}
+
+		/**
+		 * Retrieve the escape sequence of an interned style. Does not lock.
+		 *
+		 * @param  id Id returned by intern()
+		 * @return    Pointer to the escape sequence, which is not null
+		 *            terminated and stays valid as long as the registry
+		 * @see size()
+		 */
+		const char * data(const std::uint16_t id) const noexcept
+		{
+			const block & b = *blocks[id >> 8].load(std::memory_order_acquire);
+			return b.bytes + b.entries[id & 0xFF].offset;
+		}
+
+		/**
+		 * Retrieve the length of the escape sequence of an interned style.
+		 * Does not lock.
+		 *
+		 * @param  id Id returned by intern()
+		 * @return    Length of the escape sequence in bytes
+		 * @see data()
+		 */
+		std::size_t size(const std::uint16_t id) const noexcept
+		{
+			return lookup(id).length;
+		}
+
+		/**
+		 * @return Number of styles registered, including the empty style
+		 */
+		std::size_t registered() const noexcept
+		{
+			return count.load(std::memory_order_acquire);
+		}
+
+	private:
+		/**
+		 * A registered style and the location of its escape sequence.
+		 */
+		struct entry
+		{
+			style value;
+			std::uint16_t offset;
+			std::uint8_t length;
+		};
+
+		/**
+		 * Storage of 256 consecutive ids, with their escape sequences packed
+		 * back to back.
+		 */
+		struct block
+		{
+			block() : used(0) {}
+
+			entry entries[256];
+			std::size_t used;
+			char bytes[256 * style::MAX_RENDERED_SIZE];
+		};
+
+		std::atomic<block *> blocks[CAPACITY / 256];
+		std::atomic<std::size_t> count;
+		std::mutex mutex;
+		std::unordered_map<style, std::uint16_t> ids;
+
+		/**
+		 * @param  id Id returned by intern()
+		 * @return    Entry of the id
+		 */
+		const entry & lookup(const std::uint16_t id) const noexcept
+		{
+			return blocks[id >> 8]
+				.load(std::memory_order_acquire)
+				->entries[id & 0xFF];
+		}
+	};
+
+	/**
+	 * Intern a style in the process-wide registry.
+	 *
+	 * @param  s sgr whose style to intern
+	 * @return   Id of the style
+	 * @see style_registry::intern()
+	 */
+	inline std::uint16_t intern(const sgr & s)
+	{
+		return style_registry::global().intern(s);
+	}
+CPP_SGR_END_NAMESPACE
+
+#endif /* end of include guard: CPP_SGR_REGISTRY_HPP */
@@ -0,0 +1,472 @@
+/**
+ *  cpp_sgr escape sequence stripping.
+ *
+ *  @file strip.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_STRIP_HPP
+#define CPP_SGR_STRIP_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <streambuf>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPP_SGR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define CPP_SGR_AVX2 1
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+CPP_SGR_BEGIN_NAMESPACE
+	namespace detail
+	{
+		/**
+		 * @param  mask Non-zero bitmask
+		 * @return      Index of the lowest set bit
+		 */
+		inline unsigned lowest_bit(const unsigned mask) noexcept
+		{
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return static_cast<unsigned>(index);
+#else
+			return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+		}
+
+		/**
+		 * Find the first ESC character in a buffer, comparing 32 or 16 bytes
+		 * at a time where AVX2 or SSE2 is available.
+		 *
+		 * @param  begin Start of the buffer
+		 * @param  end   End of the buffer
+		 * @return       Pointer to the first ESC, or end if there is none
+		 */
+		inline const char * find_escape(const char * begin,
+										const char * end) noexcept
+		{
+#ifdef CPP_SGR_AVX2
+			const __m256i escape32 = _mm256_set1_epi8('\033');
+			while (end - begin >= 32)
+			{
+				const __m256i chunk = _mm256_loadu_si256(
+					reinterpret_cast<const __m256i *>(begin));
+				const unsigned mask = static_cast<unsigned>(
+					_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, escape32)));
+				if (mask)
+				{
+					return begin + lowest_bit(mask);
+				}
+				begin += 32;
+			}
+#endif
+#ifdef CPP_SGR_SSE2
+			const __m128i escape16 = _mm_set1_epi8('\033');
+			while (end - begin >= 16)
+			{
+				const __m128i chunk =
+					_mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+				const unsigned mask = static_cast<unsigned>(
+					_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, escape16)));
+				if (mask)
+				{
+					return begin + lowest_bit(mask);
+				}
+				begin += 16;
+			}
+#endif
+			const void * found = std::memchr(
+				begin, '\033', static_cast<std::size_t>(end - begin));
+			return found ? static_cast<const char *>(found) : end;
+		}
+
+		/**
+		 * State machine splitting the bytes following an ESC into escape
+		 * sequences and text.
+		 *
+		 * Recognizes CSI sequences (ESC '[' ... final byte), string commands
+		 * such as OSC (terminated by BEL or ESC '\\'), and other escape
+		 * sequences (ESC, intermediate bytes, final byte). A control
+		 * character aborts a sequence and is text, except for ESC, which
+		 * starts another sequence. Text between escapes is not fed to the
+		 * tokenizer; callers skip it with find_escape() and call start() at
+		 * each ESC.
+		 */
+		class escape_tokenizer
+		{
+		public:
+			/**
+			 * Roles of a byte consumed by the tokenizer.
+			 */
+			enum Token
+			{
+				TEXT_BYTE,      /**< Aborted the sequence and is text */
+				SEQUENCE_BYTE,  /**< Belongs to a sequence */
+				CSI_START,      /**< The '[' introducing a CSI sequence */
+				CSI_PARAMETER,  /**< Parameter or intermediate byte of a CSI
+									 sequence */
+				CSI_FINAL       /**< Final byte ending a CSI sequence */
+			};
+
+			/**
+			 * Construct a tokenizer starting outside of any escape sequence.
+			 */
+			escape_tokenizer() noexcept : state(TEXT) {}
+
+			/**
+			 * Enter an escape sequence after an ESC.
+			 */
+			void start() noexcept { state = ESCAPE; }
+
+			/**
+			 * @return True if within an escape sequence
+			 */
+			bool pending() const noexcept { return state != TEXT; }
+
+			/**
+			 * Forget any partial escape sequence.
+			 */
+			void reset() noexcept { state = TEXT; }
+
+			/**
+			 * Advance the state machine by one byte within an escape
+			 * sequence.
+			 *
+			 * @param  c Byte to consume
+			 * @return   Role of the byte
+			 */
+			Token consume(const char c) noexcept
+			{
+				const unsigned char byte = static_cast<unsigned char>(c);
+				switch (state)
+				{
+				case ESCAPE:
+					if (c == '[')
+					{
+						state = CSI;
+						return CSI_START;
+					}
+					if (c == ']' || c == 'P' || c == 'X' || c == '^' ||
+						c == '_')
+					{
+						state = STRING;
+						return SEQUENCE_BYTE;
+					}
+					return escapeByte(byte);
+				case INTERMEDIATE:
+					return escapeByte(byte);
+				case CSI:
+					if (byte >= 0x20 && byte <= 0x3F)
+					{
+						return CSI_PARAMETER;
+					}
+					if (byte >= 0x40 && byte <= 0x7E)
+					{
+						state = TEXT;
+						return CSI_FINAL;
+					}
+					return finalByte(byte, 0x40);
+				case STRING:
+					if (byte == 0x07)
+					{
+						state = TEXT;
+					}
+					else if (byte == 0x1B)
+					{
+						state = STRING_ESCAPE;
+					}
+					return SEQUENCE_BYTE;
+				case STRING_ESCAPE:
+					state = c == '\\' ?
+								TEXT :
+								(c == '\033' ? STRING_ESCAPE : STRING);
+					return SEQUENCE_BYTE;
+				case TEXT:
+					break;
+				}
+				return TEXT_BYTE;
+			}
+
+		private:
+			/**
+			 * Position of the tokenizer relative to escape sequences.
+			 */
+			enum State
+			{
+				TEXT,          /**< Outside of escape sequences */
+				ESCAPE,        /**< After ESC */
+				INTERMEDIATE,  /**< After ESC and intermediate bytes */
+				CSI,           /**< Within a CSI sequence */
+				STRING,        /**< Within a string command, e.g. OSC */
+				STRING_ESCAPE  /**< After ESC within a string command */
+			};
+
+			State state;
+
+			/**
+			 * Consume a byte of a sequence that is neither CSI nor a string.
+			 *
+			 * @param  byte Byte to consume
+			 * @return      See consume()
+			 */
+			Token escapeByte(const unsigned char byte) noexcept
+			{
+				if (byte >= 0x20 && byte <= 0x2F)
+				{
+					state = INTERMEDIATE;
+					return SEQUENCE_BYTE;
+				}
+				return finalByte(byte, 0x30);
+			}
+
+			/**
+			 * Consume the byte ending a sequence.
+			 *
+			 * @param  byte  Byte to consume
+			 * @param  first Lowest valid final byte
+			 * @return       See consume()
+			 */
+			Token finalByte(const unsigned char byte,
+							const unsigned char first) noexcept
+			{
+				if (byte == 0x1B)
+				{
+					state = ESCAPE;
+					return SEQUENCE_BYTE;
+				}
+				state = TEXT;
+				return byte >= first && byte <= 0x7E ? SEQUENCE_BYTE :
+													   TEXT_BYTE;
+			}
+		};
+	}   // namespace detail
+
+	/**
+	 * Incremental filter removing terminal escape sequences from text.
+	 *
+	 * @class escape_stripper
+	 * Removes CSI sequences (ESC '[' ... final byte), which include every
+	 * sequence written by sgr, string commands such as OSC hyperlinks and
+	 * window titles (terminated by BEL or ESC '\\'), and other escape
+	 * sequences (ESC, intermediate bytes, final byte). Text between escapes
+	 * is copied in bulk. The filter keeps its state between calls, so a
+	 * sequence split across chunks is removed entirely.
+	 */
+	class escape_stripper
+	{
+	public:
+		/**
+		 * Construct a filter starting outside of any escape sequence.
+		 */
+		escape_stripper() noexcept = default;
+
+		/**
+		 * Remove escape sequences from the next chunk of text.
+		 *
+		 * @param  in     Chunk of text
+		 * @param  length Length of the chunk in bytes
+		 * @param  out    Buffer of at least length bytes receiving the
+		 *                filtered text; may be the same as in
+		 * @return        Number of bytes written
+		 */
+		std::size_t strip(const char * in,
+						  const std::size_t length,
+						  char * out) noexcept
+		{
+			const char * p = in;
+			const char * const end = in + length;
+			char * o = out;
+			while (p != end)
+			{
+				if (!tokenizer.pending())
+				{
+					const char * escape = detail::find_escape(p, end);
+					const std::size_t span = static_cast<std::size_t>(escape - p);
+					if (o != p)
+					{
+						std::memmove(o, p, span);
+					}
+					o += span;
+					p = escape;
+					if (p == end)
+					{
+						break;
+					}
+					tokenizer.start();
+					++p;
+					continue;
+				}
+
+				const char c = *p++;
+				if (tokenizer.consume(c) == detail::escape_tokenizer::TEXT_BYTE)
+				{
+					*o++ = c;
+				}
+			}
+			return static_cast<std::size_t>(o - out);
+		}
+
+		/**
+		 * Remove escape sequences from the next chunk of text, appending the
+		 * filtered text to a std::string.
+		 *
+		 * @param in     Chunk of text
+		 * @param length Length of the chunk in bytes
+		 * @param out    std::string to append to
+		 */
+		void strip(const char * in, const std::size_t length, std::string & out)
+		{
+			const std::size_t start = out.size();
+			out.resize(start + length);
+			out.resize(start + strip(in, length, &out[start]));
+		}
+
+		/**
+		 * @return True if the last chunk ended inside an escape sequence
+		 */
+		bool pending() const noexcept { return tokenizer.pending(); }
+
+		/**
+		 * Forget any partial escape sequence.
+		 */
+		void reset() noexcept { tokenizer.reset(); }
+
+	private:
+		detail::escape_tokenizer tokenizer;
+	};
+
+	/**
+	 * Remove all terminal escape sequences from a buffer.
+	 *
+	 * @param  in     Text to filter
+	 * @param  length Length of the text in bytes
+	 * @param  out    Buffer of at least length bytes receiving the filtered
+	 *                text; may be the same as in
+	 * @return        Number of bytes written
+	 * @see escape_stripper
+	 */
+	inline std::size_t
+		strip_escapes(const char * in, const std::size_t length, char * out)
+	{
+		escape_stripper stripper;
+		return stripper.strip(in, length, out);
+	}
+
+	/**
+	 * Remove all terminal escape sequences from a std::string.
+	 *
+	 * @param  text Text to filter
+	 * @return      Text without escape sequences
+	 * @see escape_stripper
+	 */
+	inline std::string strip_escapes(const std::string & text)
+	{
+		std::string result;
+		escape_stripper stripper;
+		stripper.strip(text.data(), text.size(), result);
+		return result;
+	}
+
+	/**
+	 * std::streambuf removing terminal escape sequences from everything
+	 * written through it before forwarding it to another std::streambuf.
+	 *
+	 * @class stripping_buffer
+	 * Install it in place of a stream's buffer when the stream does not
+	 * write to a terminal:
+	 * @code
+	 * cpp_sgr::stripping_buffer plain(std::cout.rdbuf());
+	 * std::cout.rdbuf(&plain);
+	 * @endcode
+	 */
+	class stripping_buffer : public std::streambuf
+	{
+	public:
+		/**
+		 * Construct a stripping_buffer forwarding to another std::streambuf.
+		 *
+		 * @param target std::streambuf receiving the filtered text
+		 */
+		explicit stripping_buffer(std::streambuf * target) : target(target) {}
+
+	protected:
+		std::streamsize xsputn(const char * data, std::streamsize count) override
+		{
+			const std::streamsize total = count;
+			char chunk[4096];
+			while (count > 0)
+			{
+				const std::size_t length = static_cast<std::size_t>(
+					count < std::streamsize(sizeof(chunk))
+						? count
+						: std::streamsize(sizeof(chunk)));
+				const std::streamsize kept = static_cast<std::streamsize>(
+					stripper.strip(data, length, chunk));
+				if (kept > 0 && target->sputn(chunk, kept) != kept)
+				{
+					return total - count;
+				}
+				data += length;
+				count -= static_cast<std::streamsize>(length);
+			}
+			return total;
+		}
+
+		int_type overflow(const int_type c) override
+		{
+			if (traits_type::eq_int_type(c, traits_type::eof()))
+			{
+				return traits_type::not_eof(c);
+			}
+			const char value = traits_type::to_char_type(c);
+			return xsputn(&value, 1) == 1 ? c : traits_type::eof();
+		}
+
+		int sync() override { return target->pubsync(); }
+
+	private:
+		std::streambuf * target;
+		escape_stripper stripper;
+	};
+CPP_SGR_END_NAMESPACE
+
+#endif /* end of include guard: CPP_SGR_STRIP_HPP */
@@ -0,0 +1,258 @@
+/**
+ *  cpp_sgr styled output buffer.
+ *
+ *  @file styled_buffer.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_STYLED_BUFFER_HPP
+#define CPP_SGR_STYLED_BUFFER_HPP
+
+#include "fd_writer.hpp"
+#include "sgr.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+CPP_SGR_BEGIN_NAMESPACE
+	/**
+	 * Buffer accumulating runs of styled text for output in a single write.
+	 *
+	 * @class styled_buffer
+	 * Each run of text is appended together with the sgr it is rendered in.
+	 * The buffer keeps the escape sequences and text of all runs in one
+	 * contiguous std::string, writing only the transition between the styles
+	 * of consecutive runs; adjacent runs with equal styles are merged. The
+	 * string always ends with a transition back to the default rendition,
+	 * replaced by the next run, so the complete output is written in one
+	 * call and nothing leaks into subsequent output.
+	 *
+	 * Unlike stream insertion, the sgr of a run does not accumulate with that
+	 * of the previous run: every run starts from the default rendition.
+	 * With CPP_SGR_DISABLE defined, only the text of the runs is kept.
+	 */
+	class styled_buffer
+	{
+	public:
+		/**
+		 * Construct an empty styled_buffer.
+		 */
+		styled_buffer() = default;
+
+		/**
+		 * Construct an empty styled_buffer with room for the given number of
+		 * bytes of output.
+		 *
+		 * @param capacity Number of bytes to reserve
+		 */
+		explicit styled_buffer(const std::size_t capacity)
+		{
+			bytes.reserve(capacity);
+		}
+
+		/**
+		 * Append a run of text rendered in the given sgr.
+		 *
+		 * @param  s      sgr to render the text in
+		 * @param  text   Text of the run
+		 * @param  length Length of the text in bytes
+		 * @return        Reference to this buffer
+		 */
+		styled_buffer &
+			append(const sgr & s, const char * text, const std::size_t length)
+		{
+			return appendRun(s.getStyle().effective(), text, length);
+		}
+
+		/**
+		 * Append a run of text rendered in the given sgr.
+		 *
+		 * @param  s    sgr to render the text in
+		 * @param  text Text of the run
+		 * @return      Reference to this buffer
+		 */
+		styled_buffer & append(const sgr & s, const std::string & text)
+		{
+			return append(s, text.data(), text.size());
+		}
+
+		/**
+		 * Append a run of text rendered in the default rendition.
+		 *
+		 * @param  text   Text of the run
+		 * @param  length Length of the text in bytes
+		 * @return        Reference to this buffer
+		 */
+		styled_buffer & append(const char * text, const std::size_t length)
+		{
+			return appendRun(style(), text, length);
+		}
+
+		/**
+		 * Append a run of text rendered in the default rendition.
+		 *
+		 * @param  text Text of the run
+		 * @return      Reference to this buffer
+		 */
+		styled_buffer & append(const std::string & text)
+		{
+			return append(text.data(), text.size());
+		}
+
+		/**
+		 * @return Number of bytes written by writeTo(), including the final
+		 * transition back to the default rendition
+		 */
+		std::size_t size() const { return bytes.size(); }
+
+		/**
+		 * @return True if no text or escape sequences have been appended
+		 */
+		bool empty() const { return bytes.empty(); }
+
+		/**
+		 * Discard all runs, keeping the allocated capacity.
+		 */
+		void clear()
+		{
+			bytes.clear();
+			endLength = 0;
+			current = style();
+		}
+
+		/**
+		 * Retrieve the complete output of this buffer.
+		 *
+		 * @return std::string holding the output written by writeTo()
+		 */
+		std::string str() const { return bytes; }
+
+		/**
+		 * Write the complete output of this buffer into a std::ostream's
+		 * buffer. Marks the stream bad on failure.
+		 *
+		 * @param stream Stream to write to
+		 */
+		void writeTo(std::ostream & stream) const
+		{
+			const std::streamsize count =
+				static_cast<std::streamsize>(bytes.size());
+			if (!stream.rdbuf() ||
+				stream.rdbuf()->sputn(bytes.data(), count) != count)
+			{
+				stream.setstate(std::ios_base::badbit);
+			}
+		}
+
+		/**
+		 * Write the complete output of this buffer into a C stream.
+		 *
+		 * @param  file C stream to write to
+		 * @return      True if all output was written, else false
+		 */
+		bool writeTo(std::FILE * file) const
+		{
+			return std::fwrite(bytes.data(), 1, bytes.size(), file) ==
+				   bytes.size();
+		}
+
+		/**
+		 * Write the complete output of this buffer to a file descriptor in a
+		 * single write where possible, retrying after partial writes and
+		 * interruptions.
+		 *
+		 * @param  fd File descriptor to write to
+		 * @return    True if all output was written, else false
+		 */
+		bool writeTo(const int fd) const
+		{
+			detail::io_vector vector;
+			vector.iov_base = const_cast<char *>(bytes.data());
+			vector.iov_len = bytes.size();
+			return detail::write_vectors(fd, &vector, 1);
+		}
+
+	private:
+		std::string bytes;
+		std::size_t endLength = 0;
+		style current;
+
+		/**
+		 * Append a run of text rendered in the given rendition.
+		 *
+		 * @param  target Rendition of the run
+		 * @param  text   Text of the run
+		 * @param  length Length of the text in bytes
+		 * @return        Reference to this buffer
+		 */
+		styled_buffer & appendRun(const style & target,
+								  const char * text,
+								  const std::size_t length)
+		{
+			if (length == 0)
+			{
+				return *this;
+			}
+
+#ifdef CPP_SGR_DISABLE
+			static_cast<void>(target);
+			bytes.append(text, length);
+#else
+			char transition[style::MAX_TRANSITION_SIZE];
+			bytes.resize(bytes.size() - endLength);
+			bytes.append(transition,
+						 style::writeTransition(current, target, transition));
+			current = target;
+			bytes.append(text, length);
+
+			const std::size_t before = bytes.size();
+			bytes.append(transition,
+						 style::writeTransition(current, style(), transition));
+			endLength = bytes.size() - before;
+#endif
+			return *this;
+		}
+	};
+
+	/**
+	 * Write the complete output of a styled_buffer into a std::ostream.
+	 *
+	 * @param  out    std::ostream to write to
+	 * @param  buffer styled_buffer to write
+	 * @return        The given std::ostream
+	 */
+	inline std::ostream & operator<<(std::ostream & out,
+									 const styled_buffer & buffer)
+	{
+		buffer.writeTo(out);
+		return out;
+	}
+CPP_SGR_END_NAMESPACE
+
+#endif /* end of include guard: CPP_SGR_STYLED_BUFFER_HPP */
@@ -0,0 +1,422 @@
+/**
+ *  cpp_sgr terminal capability detection.
+ *
+ *  @file terminal.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_TERMINAL_HPP
+#define CPP_SGR_TERMINAL_HPP
+
+#include "sgr.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+CPP_SGR_BEGIN_NAMESPACE
+	namespace detail
+	{
+		/**
+		 * Read the "colors" capability from a compiled terminfo entry, in
+		 * either the legacy format (magic 0432) or the format with 32-bit
+		 * numbers (magic 01036).
+		 *
+		 * @param  data Contents of the terminfo file
+		 * @param  size Size of the contents in bytes
+		 * @return      Number of colors, -1 if the entry does not have the
+		 *              capability, or -2 if the entry is malformed
+		 */
+		inline long parse_terminfo_colors(const unsigned char * data,
+										  const std::size_t size) noexcept
+		{
+			if (size < 12)
+			{
+				return -2;
+			}
+
+			const auto read16 = [data](const std::size_t offset) {
+				return static_cast<unsigned>(data[offset] |
+											 data[offset + 1] << 8);
+			};
+			const unsigned magic = read16(0);
+			const std::size_t width =
+				magic == 0432 ? 2 : (magic == 01036 ? 4 : 0);
+			if (width == 0)
+			{
+				return -2;
+			}
+
+			// The numbers follow the header, names and booleans, aligned to
+			// an even offset
+			const std::size_t colorsIndex = 13;
+			const std::size_t numbers = read16(6);
+			std::size_t offset = 12 + read16(2) + read16(4);
+			offset += offset & 1;
+			if (numbers <= colorsIndex)
+			{
+				return -1;
+			}
+			offset += colorsIndex * width;
+			if (offset + width > size)
+			{
+				return -2;
+			}
+
+			long colors;
+			if (width == 2)
+			{
+				colors = static_cast<std::int16_t>(read16(offset));
+			}
+			else
+			{
+				colors = static_cast<std::int32_t>(
+					std::uint32_t(read16(offset)) |
+					std::uint32_t(read16(offset + 2)) << 16);
+			}
+			return colors < 0 ? -1 : colors;
+		}
+
+#ifndef _WIN32
+		/**
+		 * Read the "colors" capability from a compiled terminfo file, mapped
+		 * into memory.
+		 *
+		 * @param  path Path of the terminfo file
+		 * @return      See parse_terminfo_colors(); -2 if the file cannot
+		 *              be read
+		 */
+		inline long read_terminfo_colors(const std::string & path) noexcept
+		{
+			const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0)
+			{
+				return -2;
+			}
+			struct stat info;
+			if (::fstat(fd, &info) != 0 || info.st_size < 12)
+			{
+				::close(fd);
+				return -2;
+			}
+
+			const std::size_t size = static_cast<std::size_t>(info.st_size);
+			void * map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+			if (map == MAP_FAILED)
+			{
+				return -2;
+			}
+			const long colors = parse_terminfo_colors(
+				static_cast<const unsigned char *>(map), size);
+			::munmap(map, size);
+			return colors;
+		}
+
+		/**
+		 * Look up the "colors" capability of a terminal in the terminfo
+		 * database, searching the same directories as ncurses.
+		 *
+		 * @param  term Terminal name, as in the TERM environment variable
+		 * @return      See parse_terminfo_colors(); -2 if no entry is found
+		 */
+		inline long terminfo_colors(const char * term)
+		{
+			if (!term || !*term || std::strchr(term, '/'))
+			{
+				return -2;
+			}
+
+			std::string directories;
+			if (const char * terminfo = std::getenv("TERMINFO"))
+			{
+				directories.append(terminfo).append(":");
+			}
+			if (const char * home = std::getenv("HOME"))
+			{
+				directories.append(home).append("/.terminfo:");
+			}
+			if (const char * dirs = std::getenv("TERMINFO_DIRS"))
+			{
+				directories.append(dirs).append(":");
+			}
+			directories.append("/etc/terminfo:/lib/terminfo:"
+							   "/usr/share/terminfo:/usr/lib/terminfo");
+
+			static const char hex[] = "0123456789abcdef";
+			const unsigned char first = static_cast<unsigned char>(term[0]);
+			std::size_t start = 0;
+			while (start <= directories.size())
+			{
+				std::size_t end = directories.find(':', start);
+				if (end == std::string::npos)
+				{
+					end = directories.size();
+				}
+				// An empty entry of TERMINFO_DIRS stands for the default
+				const std::string directory =
+					end == start ? std::string("/usr/share/terminfo")
+								 : directories.substr(start, end - start);
+				start = end + 1;
+
+				// Entries are filed under their first character, or its
+				// hexadecimal code on case-insensitive file systems
+				long colors = read_terminfo_colors(directory + '/' +
+												   char(first) + '/' + term);
+				if (colors == -2)
+				{
+					colors = read_terminfo_colors(directory + '/' +
+												  hex[first >> 4] +
+												  hex[first & 15] + '/' + term);
+				}
+				if (colors != -2)
+				{
+					return colors;
+				}
+			}
+			return -2;
+		}
+#endif
+
+		/**
+		 * Determine the color depth of a terminal from its TERM and COLORTERM
+		 * environment variables and terminfo entry.
+		 *
+		 * @return Color depth of the terminal the process runs in
+		 */
+		inline ColorDepth terminal_type_depth()
+		{
+#ifdef _WIN32
+			return TRUECOLOR;
+#else
+			const char * term = std::getenv("TERM");
+			if (!term || !*term)
+			{
+				return ANSI_16;
+			}
+			if (std::strcmp(term, "dumb") == 0)
+			{
+				return PLAIN;
+			}
+
+			const char * colorterm = std::getenv("COLORTERM");
+			if (colorterm && (std::strcmp(colorterm, "truecolor") == 0 ||
+							  std::strcmp(colorterm, "24bit") == 0))
+			{
+				return TRUECOLOR;
+			}
+
+			const long colors = terminfo_colors(term);
+			if (colors >= (1L << 24))
+			{
+				return TRUECOLOR;
+			}
+			if (colors >= 256)
+			{
+				return INDEXED_256;
+			}
+			if (colors >= 8)
+			{
+				return ANSI_16;
+			}
+			if (colors != -2)
+			{
+				return MONOCHROME;
+			}
+
+			// Without a terminfo entry, go by the terminal's name
+			if (std::strstr(term, "direct") || std::strstr(term, "truecolor"))
+			{
+				return TRUECOLOR;
+			}
+			return std::strstr(term, "256") ? INDEXED_256 : ANSI_16;
+#endif
+		}
+
+		/**
+		 * Probe the color depth of the output behind a file descriptor,
+		 * without caching.
+		 *
+		 * FORCE_COLOR sets a minimum depth even when the output is not a
+		 * terminal (0 or "false" disables escape sequences, 2 means 256
+		 * colors, 3 means 24-bit colors, anything else 16 colors). Otherwise
+		 * non-terminals get PLAIN, and NO_COLOR limits terminals to
+		 * MONOCHROME.
+		 *
+		 * @param  fd File descriptor to probe
+		 * @return    Color depth of the output
+		 */
+		inline ColorDepth probe_terminal_depth(const int fd)
+		{
+#ifdef _WIN32
+			const bool terminal = _isatty(fd) != 0;
+#else
+			const bool terminal = ::isatty(fd) != 0;
+#endif
+			const ColorDepth detected =
+				terminal ? terminal_type_depth() : PLAIN;
+
+			if (const char * force = std::getenv("FORCE_COLOR"))
+			{
+				if (std::strcmp(force, "0") == 0 ||
+					std::strcmp(force, "false") == 0)
+				{
+					return PLAIN;
+				}
+				const ColorDepth forced =
+					std::strcmp(force, "3") == 0
+						? TRUECOLOR
+						: (std::strcmp(force, "2") == 0 ? INDEXED_256
+														: ANSI_16);
+				// Lower values are deeper
+				return detected < forced ? detected : forced;
+			}
+
+			const char * noColor = std::getenv("NO_COLOR");
+			if (noColor && *noColor && detected < MONOCHROME)
+			{
+				return MONOCHROME;
+			}
+			return detected;
+		}
+
+		/**
+		 * Cached color depths of the first file descriptors, each stored
+		 * as the ColorDepth plus one, or 0 if not probed yet.
+		 */
+		struct terminal_cache
+		{
+			enum : int
+			{
+				SIZE = 64 /**< Number of file descriptors cached */
+			};
+
+			std::atomic<int> depths[SIZE];
+		};
+
+		/**
+		 * @return Cache of color depths, zero-initialized before first use
+		 */
+		inline terminal_cache & terminal_depths()
+		{
+			static terminal_cache cache;
+			return cache;
+		}
+	}   // namespace detail
+
+	/**
+	 * Retrieve the color depth of the output behind a file descriptor.
+	 *
+	 * The output is probed on the first call for each file descriptor: see
+	 * detail::probe_terminal_depth() for the environment variables
+	 * consulted. The terminfo database is read from local files. The result
+	 * is cached for descriptors below 64, so later calls are a single atomic
+	 * load; other descriptors are probed every time.
+	 *
+	 * @param  fd File descriptor, e.g. 1 for standard output
+	 * @return    Color depth of the output
+	 */
+	inline ColorDepth terminal_depth(const int fd)
+	{
+		if (fd < 0 || fd >= detail::terminal_cache::SIZE)
+		{
+			return detail::probe_terminal_depth(fd);
+		}
+
+		std::atomic<int> & cached = detail::terminal_depths().depths[fd];
+		const int value = cached.load(std::memory_order_relaxed);
+		if (value != 0)
+		{
+			return static_cast<ColorDepth>(value - 1);
+		}
+
+		const ColorDepth depth = detail::probe_terminal_depth(fd);
+		int expected = 0;
+		// Keep an override set while probing
+		cached.compare_exchange_strong(expected, depth + 1,
+									   std::memory_order_relaxed);
+		return expected == 0 ? depth : static_cast<ColorDepth>(expected - 1);
+	}
+
+	/**
+	 * Override the color depth reported for a file descriptor, e.g. in
+	 * tests. Only descriptors below 64 can be overridden.
+	 *
+	 * @param fd    File descriptor
+	 * @param depth Color depth to report
+	 */
+	inline void set_terminal_depth(const int fd, const ColorDepth depth)
+	{
+		if (fd >= 0 && fd < detail::terminal_cache::SIZE)
+		{
+			detail::terminal_depths().depths[fd].store(
+				depth + 1, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * Forget the cached or overridden color depth of a file descriptor, so
+	 * the next call to terminal_depth() probes it again.
+	 *
+	 * @param fd File descriptor
+	 */
+	inline void clear_terminal_depth(const int fd)
+	{
+		if (fd >= 0 && fd < detail::terminal_cache::SIZE)
+		{
+			detail::terminal_depths().depths[fd].store(
+				0, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * Limit the output of a stream to the color depth of the file
+	 * descriptor it writes to.
+	 *
+	 * @param stream Stream to configure, e.g. std::cout
+	 * @param fd     File descriptor the stream writes to, e.g. 1
+	 * @see color_depth()
+	 */
+	inline void detect_color_depth(std::ostream & stream, const int fd)
+	{
+		color_depth(stream, terminal_depth(fd));
+	}
+CPP_SGR_END_NAMESPACE
+
+#endif /* end of include guard: CPP_SGR_TERMINAL_HPP */
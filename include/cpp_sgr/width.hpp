@@ -0,0 +1,606 @@
+/**
+ *  cpp_sgr display width of styled text.
+ *
+ *  @file width.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_WIDTH_HPP
+#define CPP_SGR_WIDTH_HPP
+
+#include "strip.hpp"
+#include "width_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+CPP_SGR_BEGIN_NAMESPACE
+	namespace detail
+	{
+		/**
+		 * @param  c Character to check
+		 * @return   True if the character is in the range [0x20,0x7E]
+		 */
+		constexpr bool is_printable_ascii(const char c) noexcept
+		{
+			return static_cast<unsigned char>(c) >= 0x20 &&
+				   static_cast<unsigned char>(c) < 0x7F;
+		}
+
+		/**
+		 * Count the printable ASCII characters at the start of a buffer,
+		 * checking 32 or 16 bytes at a time where AVX2 or SSE2 is available.
+		 *
+		 * @param  begin Start of the buffer
+		 * @param  end   End of the buffer
+		 * @return       Number of leading bytes in the range [0x20,0x7E]
+		 */
+		inline std::size_t printable_ascii_prefix(const char * begin,
+												  const char * end) noexcept
+		{
+			const char * p = begin;
+#ifdef CPP_SGR_AVX2
+			const __m256i space32 = _mm256_set1_epi8(0x20);
+			const __m256i delete32 = _mm256_set1_epi8(0x7F);
+			while (end - p >= 32)
+			{
+				const __m256i chunk =
+					_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+				// Signed comparison also catches bytes from 0x80 on
+				const unsigned mask =
+					static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(
+						_mm256_cmpgt_epi8(space32, chunk),
+						_mm256_cmpeq_epi8(chunk, delete32))));
+				if (mask)
+				{
+					return static_cast<std::size_t>(p - begin) +
+						   lowest_bit(mask);
+				}
+				p += 32;
+			}
+#endif
+#ifdef CPP_SGR_SSE2
+			const __m128i space16 = _mm_set1_epi8(0x20);
+			const __m128i delete16 = _mm_set1_epi8(0x7F);
+			while (end - p >= 16)
+			{
+				const __m128i chunk =
+					_mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+				const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+					_mm_or_si128(_mm_cmplt_epi8(chunk, space16),
+								 _mm_cmpeq_epi8(chunk, delete16))));
+				if (mask)
+				{
+					return static_cast<std::size_t>(p - begin) +
+						   lowest_bit(mask);
+				}
+				p += 16;
+			}
+#endif
+			while (p != end && is_printable_ascii(*p))
+			{
+				++p;
+			}
+			return static_cast<std::size_t>(p - begin);
+		}
+
+		/**
+		 * Find the end of the escape sequence starting at an ESC, as split by
+		 * escape_tokenizer. A sequence cut short ends at the byte that
+		 * aborted it.
+		 *
+		 * @param  p   Pointer to the ESC
+		 * @param  end End of the buffer
+		 * @return     Pointer past the escape sequence
+		 */
+		inline const char * escape_end(const char * p,
+									   const char * end) noexcept
+		{
+			escape_tokenizer tokenizer;
+			tokenizer.start();
+			for (++p; p != end; ++p)
+			{
+				if (tokenizer.consume(*p) == escape_tokenizer::TEXT_BYTE)
+				{
+					return p;
+				}
+				if (!tokenizer.pending())
+				{
+					return p + 1;
+				}
+			}
+			return end;
+		}
+
+		/**
+		 * Decode one UTF-8 encoded code point. Malformed, overlong and
+		 * surrogate encodings decode as U+FFFD, consuming a single byte.
+		 *
+		 * @param  p   Pointer to the first byte; must be before end
+		 * @param  end End of the buffer
+		 * @param  cp  Receives the code point
+		 * @return     Pointer past the decoded bytes
+		 */
+		inline const char *
+			decode_utf8(const char * p, const char * end, std::uint32_t & cp)
+				noexcept
+		{
+			const unsigned char lead = static_cast<unsigned char>(*p);
+			std::size_t length;
+			std::uint32_t minimum;
+			if (lead < 0x80)
+			{
+				cp = lead;
+				return p + 1;
+			}
+			else if (lead < 0xC2 || lead > 0xF4)
+			{
+				cp = 0xFFFD;
+				return p + 1;
+			}
+			else if (lead < 0xE0)
+			{
+				length = 2;
+				minimum = 0x80;
+				cp = lead & 0x1F;
+			}
+			else if (lead < 0xF0)
+			{
+				length = 3;
+				minimum = 0x800;
+				cp = lead & 0x0F;
+			}
+			else
+			{
+				length = 4;
+				minimum = 0x10000;
+				cp = lead & 0x07;
+			}
+
+			if (static_cast<std::size_t>(end - p) < length)
+			{
+				cp = 0xFFFD;
+				return p + 1;
+			}
+			for (std::size_t i = 1; i < length; ++i)
+			{
+				const unsigned char byte = static_cast<unsigned char>(p[i]);
+				if ((byte & 0xC0) != 0x80)
+				{
+					cp = 0xFFFD;
+					return p + 1;
+				}
+				cp = cp << 6 | (byte & 0x3F);
+			}
+			if (cp < minimum || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+			{
+				cp = 0xFFFD;
+				return p + 1;
+			}
+			return p + length;
+		}
+
+		/**
+		 * @param  cp Code point
+		 * @return    Number of terminal columns the code point occupies
+		 */
+		inline unsigned code_point_width(const std::uint32_t cp) noexcept
+		{
+			if (cp < width_table::LIMIT)
+			{
+				return width_table::lookup(cp);
+			}
+			// Tags and variation selectors are invisible, the rest is narrow
+			return cp >= 0xE0000 && cp <= 0xE0FFF ? 0 : 1;
+		}
+
+		/**
+		 * Escape sequence or code point at a position in a text.
+		 */
+		struct text_unit
+		{
+			const char * end; /**< Pointer past the unit */
+			unsigned width;   /**< Columns occupied */
+			bool escape;      /**< True for an escape sequence */
+		};
+
+		/**
+		 * @param  p   Start of the unit; must be before end
+		 * @param  end End of the text
+		 * @return     The escape sequence or code point starting at p
+		 */
+		inline text_unit next_unit(const char * p, const char * end) noexcept
+		{
+			if (*p == '\033')
+			{
+				return text_unit{escape_end(p, end), 0, true};
+			}
+			std::uint32_t cp;
+			const char * next = decode_utf8(p, end, cp);
+			return text_unit{next, code_point_width(cp), false};
+		}
+
+		/**
+		 * Append text cut to a display width, ending in an ellipsis if it was
+		 * cut. Escape sequences beyond the cut are appended after the
+		 * ellipsis, so styles and resets still take effect. Measures and
+		 * cuts in a single pass over the text.
+		 *
+		 * @param  text     Text to append
+		 * @param  length   Length of the text in bytes
+		 * @param  width    Maximum display width
+		 * @param  ellipsis UTF-8 text marking the cut; dropped if it does not
+		 *                  fit either
+		 * @param  out      std::string to append to
+		 * @return          Display width appended
+		 */
+		inline std::size_t append_truncated(const char * text,
+											const std::size_t length,
+											const std::size_t width,
+											const char * ellipsis,
+											std::string & out)
+		{
+			std::size_t ellipsisLength = std::strlen(ellipsis);
+			std::size_t ellipsisWidth = 0;
+			for (const char * e = ellipsis; e != ellipsis + ellipsisLength;)
+			{
+				const text_unit unit = next_unit(e, ellipsis + ellipsisLength);
+				ellipsisWidth += unit.width;
+				e = unit.end;
+			}
+			if (ellipsisWidth > width)
+			{
+				ellipsisLength = 0;
+				ellipsisWidth = 0;
+			}
+
+			// Text up to cut fits in budget columns, leaving room for the
+			// ellipsis
+			const std::size_t budget = width - ellipsisWidth;
+			const char * const end = text + length;
+			const char * cut = nullptr;
+			std::size_t cutWidth = 0;
+			std::size_t used = 0;
+			const char * p = text;
+			while (p != end && used <= width)
+			{
+				if (is_printable_ascii(*p))
+				{
+					const std::size_t run = printable_ascii_prefix(p, end);
+					if (!cut && used + run > budget)
+					{
+						cut = p + (budget - used);
+						cutWidth = budget;
+					}
+					used += run;
+					p += run;
+					continue;
+				}
+
+				const text_unit unit = next_unit(p, end);
+				if (!unit.escape)
+				{
+					if (!cut && used + unit.width > budget)
+					{
+						cut = p;
+						cutWidth = used;
+					}
+					used += unit.width;
+				}
+				p = unit.end;
+			}
+
+			if (used <= width)
+			{
+				out.append(text, length);
+				return used;
+			}
+
+			out.append(text, static_cast<std::size_t>(cut - text));
+			// A wide character may not fit into the last column
+			out.append(budget - cutWidth, ' ');
+			out.append(ellipsis, ellipsisLength);
+			for (p = find_escape(cut, end); p != end; p = find_escape(p, end))
+			{
+				const char * sequence = p;
+				p = escape_end(p, end);
+				out.append(sequence, static_cast<std::size_t>(p - sequence));
+			}
+			return width;
+		}
+	}   // namespace detail
+
+	/**
+	 * Horizontal alignments of padded text.
+	 */
+	enum Alignment
+	{
+		ALIGN_LEFT,  /**< Padding after the text */
+		ALIGN_RIGHT, /**< Padding before the text */
+		ALIGN_CENTER /**< Padding split around the text, more after it */
+	};
+
+	namespace detail
+	{
+		/**
+		 * @param  extra Columns of padding in total
+		 * @param  align Position of the text within the padding
+		 * @return       Columns of padding before the text
+		 */
+		constexpr std::size_t padding_before(const std::size_t extra,
+											 const Alignment align) noexcept
+		{
+			return align == ALIGN_RIGHT ?
+					   extra :
+					   (align == ALIGN_CENTER ? extra / 2 : 0);
+		}
+	}   // namespace detail
+
+	/**
+	 * Compute the number of terminal columns text occupies. Escape sequences
+	 * take no columns, East Asian wide and fullwidth characters take two, and
+	 * combining marks, other zero-width characters and control characters,
+	 * including tabs, take none. Malformed UTF-8 counts one column per byte.
+	 * Widths are those of individual code points, so emoji sequences joined
+	 * by U+200D count every emoji. Runs of printable ASCII are measured 16 or
+	 * 32 bytes at a time where SSE2 or AVX2 is available.
+	 *
+	 * @param  text   UTF-8 text
+	 * @param  length Length of the text in bytes
+	 * @return        Display width in columns
+	 */
+	inline std::size_t display_width(const char * text,
+									 const std::size_t length) noexcept
+	{
+		const char * p = text;
+		const char * const end = text + length;
+		std::size_t width = 0;
+		while (p != end)
+		{
+			if (detail::is_printable_ascii(*p))
+			{
+				const std::size_t run = detail::printable_ascii_prefix(p, end);
+				width += run;
+				p += run;
+				if (p == end)
+				{
+					break;
+				}
+			}
+			const detail::text_unit unit = detail::next_unit(p, end);
+			width += unit.width;
+			p = unit.end;
+		}
+		return width;
+	}
+
+	/**
+	 * Compute the number of terminal columns text occupies.
+	 *
+	 * @param  text UTF-8 text
+	 * @return      Display width in columns
+	 * @see display_width(const char * text, const std::size_t length)
+	 */
+	inline std::size_t display_width(const std::string & text) noexcept
+	{
+		return display_width(text.data(), text.size());
+	}
+
+	/**
+	 * Append text padded to a display width, keeping its escape sequences.
+	 * Text at least as wide is appended unchanged.
+	 *
+	 * @param  text   UTF-8 text
+	 * @param  length Length of the text in bytes
+	 * @param  width  Display width to pad to
+	 * @param  out    std::string to append to
+	 * @param  align  Position of the text within the width
+	 * @param  fill   Character to pad with
+	 * @return        Display width appended
+	 */
+	inline std::size_t pad(const char * text,
+						   const std::size_t length,
+						   const std::size_t width,
+						   std::string & out,
+						   const Alignment align = ALIGN_LEFT,
+						   const char fill = ' ')
+	{
+		const std::size_t actual = display_width(text, length);
+		if (actual >= width)
+		{
+			out.append(text, length);
+			return actual;
+		}
+
+		const std::size_t extra = width - actual;
+		const std::size_t before = detail::padding_before(extra, align);
+		out.append(before, fill);
+		out.append(text, length);
+		out.append(extra - before, fill);
+		return width;
+	}
+
+	/**
+	 * Pad text to a display width, keeping its escape sequences.
+	 *
+	 * @param  text  UTF-8 text
+	 * @param  width Display width to pad to
+	 * @param  align Position of the text within the width
+	 * @param  fill  Character to pad with
+	 * @return       Padded text
+	 */
+	inline std::string pad(const std::string & text,
+						   const std::size_t width,
+						   const Alignment align = ALIGN_LEFT,
+						   const char fill = ' ')
+	{
+		std::string result;
+		result.reserve(text.size() + width);
+		pad(text.data(), text.size(), width, result, align, fill);
+		return result;
+	}
+
+	/**
+	 * Append text centered within a display width, keeping its escape
+	 * sequences.
+	 *
+	 * @param  text   UTF-8 text
+	 * @param  length Length of the text in bytes
+	 * @param  width  Display width to center within
+	 * @param  out    std::string to append to
+	 * @param  fill   Character to pad with
+	 * @return        Display width appended
+	 */
+	inline std::size_t center(const char * text,
+							  const std::size_t length,
+							  const std::size_t width,
+							  std::string & out,
+							  const char fill = ' ')
+	{
+		return pad(text, length, width, out, ALIGN_CENTER, fill);
+	}
+
+	/**
+	 * Center text within a display width, keeping its escape sequences.
+	 *
+	 * @param  text  UTF-8 text
+	 * @param  width Display width to center within
+	 * @param  fill  Character to pad with
+	 * @return       Centered text
+	 */
+	inline std::string center(const std::string & text,
+							  const std::size_t width,
+							  const char fill = ' ')
+	{
+		return pad(text, width, ALIGN_CENTER, fill);
+	}
+
+	/**
+	 * Append text cut to a display width, ending in an ellipsis if it had to
+	 * be cut. All escape sequences are kept, including those of the cut
+	 * part, so styles and resets still take effect.
+	 *
+	 * @param  text     UTF-8 text
+	 * @param  length   Length of the text in bytes
+	 * @param  width    Maximum display width
+	 * @param  out      std::string to append to
+	 * @param  ellipsis UTF-8 text marking the cut; dropped if wider than
+	 *                  the width
+	 * @return          Display width appended
+	 */
+	inline std::size_t truncate(const char * text,
+								const std::size_t length,
+								const std::size_t width,
+								std::string & out,
+								const char * ellipsis = "\xE2\x80\xA6")
+	{
+		return detail::append_truncated(text, length, width, ellipsis, out);
+	}
+
+	/**
+	 * Cut text to a display width, ending in an ellipsis if it had to be
+	 * cut, keeping all escape sequences.
+	 *
+	 * @param  text     UTF-8 text
+	 * @param  width    Maximum display width
+	 * @param  ellipsis UTF-8 text marking the cut
+	 * @return          Truncated text
+	 */
+	inline std::string truncate(const std::string & text,
+								const std::size_t width,
+								const char * ellipsis = "\xE2\x80\xA6")
+	{
+		std::string result;
+		truncate(text.data(), text.size(), width, result, ellipsis);
+		return result;
+	}
+
+	/**
+	 * Append text fit to exactly a display width, truncating it with an
+	 * ellipsis if it is wider and padding it otherwise, in a single pass
+	 * over the text. All escape sequences are kept.
+	 *
+	 * @param  text     UTF-8 text
+	 * @param  length   Length of the text in bytes
+	 * @param  width    Display width to fit to
+	 * @param  out      std::string to append to
+	 * @param  align    Position of narrower text within the width
+	 * @param  ellipsis UTF-8 text marking a cut
+	 * @param  fill     Character to pad with
+	 * @return          Display width appended
+	 */
+	inline std::size_t fit(const char * text,
+						   const std::size_t length,
+						   const std::size_t width,
+						   std::string & out,
+						   const Alignment align = ALIGN_LEFT,
+						   const char * ellipsis = "\xE2\x80\xA6",
+						   const char fill = ' ')
+	{
+		const std::size_t start = out.size();
+		const std::size_t actual =
+			detail::append_truncated(text, length, width, ellipsis, out);
+		if (actual >= width)
+		{
+			return actual;
+		}
+
+		const std::size_t extra = width - actual;
+		const std::size_t before = detail::padding_before(extra, align);
+		out.insert(start, before, fill);
+		out.append(extra - before, fill);
+		return width;
+	}
+
+	/**
+	 * Fit text to exactly a display width, truncating it with an ellipsis if
+	 * it is wider and padding it otherwise, keeping all escape sequences.
+	 *
+	 * @param  text     UTF-8 text
+	 * @param  width    Display width to fit to
+	 * @param  align    Position of narrower text within the width
+	 * @param  ellipsis UTF-8 text marking a cut
+	 * @param  fill     Character to pad with
+	 * @return          Fitted text
+	 */
+	inline std::string fit(const std::string & text,
+						   const std::size_t width,
+						   const Alignment align = ALIGN_LEFT,
+						   const char * ellipsis = "\xE2\x80\xA6",
+						   const char fill = ' ')
+	{
+		std::string result;
+		result.reserve(text.size() + width);
+		fit(text.data(), text.size(), width, result, align, ellipsis, fill);
+		return result;
+	}
+CPP_SGR_END_NAMESPACE
+
+#endif /* end of include guard: CPP_SGR_WIDTH_HPP */
@@ -0,0 +1,1475 @@
+/**
+ *  cpp_sgr display width table.
+ *
+ *  @file width_table.hpp
+ */
+
+/*
+
+  MIT License
+
+  Copyright (c) 2018 Matthew Hatch
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+ */
+
+#ifndef CPP_SGR_WIDTH_TABLE_HPP
+#define CPP_SGR_WIDTH_TABLE_HPP
+
+#include "config.hpp"
+
+#include <cstdint>
+
+// Generated by tools/generate_width_table.py from Unicode 14.0.0
+// data; do not edit.
+
+CPP_SGR_BEGIN_NAMESPACE
+	namespace detail
+	{
+		/**
+		 * Display widths of the code points below 0x40000, packed
+		 * into a two-level table of 2-bit entries.
+		 */
+		struct width_table
+		{
+			enum : std::uint32_t
+			{
+				LIMIT = 0x40000,
+				BLOCK_SHIFT = 8
+			};
+
+			/**
+			 * @return Version of the Unicode data the table was
+			 * generated from
+			 */
+			static constexpr const char * unicode_version() noexcept
+			{
+				return "14.0.0";
+			}
+
+			/**
+			 * @param  cp Code point below LIMIT
+			 * @return    Display width: 0, 1 or 2 columns
+			 */
+			static unsigned lookup(const std::uint32_t cp) noexcept
+			{
+				const std::uint8_t * block =
+					blocks()[index()[cp >> BLOCK_SHIFT]];
+				const unsigned offset = cp & 0xFF;
+				return block[offset >> 2] >> (offset & 3) * 2 & 3;
+			}
+
+			/**
+			 * @return Index of the block of each 256 code points
+			 */
+			static const std::uint8_t * index() noexcept
+			{
+				static const std::uint8_t table[1024] = {
+					0x00, 0x01, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+					0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12,
+					0x01, 0x01, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A,
+					0x01, 0x1B, 0x1C, 0x1D, 0x01, 0x1E, 0x1F, 0x20, 0x21, 0x22,
+					0x01, 0x01, 0x01, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x27,
+					0x29, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x2A, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x2B, 0x01, 0x2C, 0x2D, 0x2E, 0x2F,
+					0x30, 0x31, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x32, 0x01, 0x01, 0x01, 0x01,
+					0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+					0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+					0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x27,
+					0x27, 0x33, 0x01, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A,
+					0x3B, 0x3C, 0x01, 0x3D, 0x3E, 0x3F, 0x40, 0x41, 0x42, 0x43,
+					0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D,
+					0x4E, 0x4F, 0x50, 0x27, 0x51, 0x52, 0x53, 0x54, 0x01, 0x01,
+					0x01, 0x55, 0x56, 0x57, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x58, 0x01, 0x01, 0x01, 0x01, 0x59, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x01, 0x01, 0x5A, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x01, 0x01, 0x5B, 0x5C, 0x27, 0x27, 0x5D, 0x5E, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x5F, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66,
+					0x67, 0x68, 0x01, 0x01, 0x69, 0x27, 0x27, 0x27, 0x27, 0x6A,
+					0x6B, 0x6C, 0x6D, 0x27, 0x27, 0x27, 0x27, 0x6E, 0x6F, 0x70,
+					0x27, 0x27, 0x71, 0x72, 0x73, 0x27, 0x74, 0x75, 0x27, 0x76,
+					0x77, 0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+					0x27, 0x27, 0x27, 0x27,
+				};
+				return table;
+			}
+
+			/**
+			 * @return Distinct blocks of packed widths
+			 */
+			static const std::uint8_t (*blocks() noexcept)[64]
+			{
+				static const std::uint8_t table[127][64] = {
+					{
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00, 0x55, 0x55, 0x5A, 0x55, 0xAA, 0x55, 0x95, 0x59,
+						0x55, 0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x50, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x95, 0x56, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x56,
+						0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x10, 0x41, 0x10, 0xAA, 0xAA, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x95, 0x6A, 0x55, 0xA9, 0xAA,
+						0xAA,
+					},
+					{
+						0x00, 0x50, 0x55, 0x55, 0x00, 0x00, 0x40, 0x54, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x55, 0x55,
+						0x55, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05,
+						0x00, 0x10, 0x00, 0x14, 0x04, 0x50, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x25, 0x51, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x80, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00, 0x00, 0xA4,
+						0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x00, 0x55, 0x95,
+						0x52,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x10, 0x00, 0x00,
+						0x01, 0x01, 0xA0, 0x55, 0x55, 0x55, 0x95, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x01, 0x9A, 0x55, 0x55, 0x95,
+						0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+						0xA0, 0xAA, 0x00, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00,
+					},
+					{
+						0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x45, 0x54, 0x01, 0x00,
+						0x54, 0x51, 0x01, 0x00, 0x55, 0x55, 0x05, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x51, 0x56, 0x55, 0x69,
+						0x69, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x99,
+						0x5A, 0xA5, 0x54, 0x01, 0x68, 0x69, 0x91, 0xAA, 0x6A,
+						0xAA, 0x65, 0x05, 0x5A, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x85,
+					},
+					{
+						0x42, 0x56, 0x95, 0x6A, 0x69, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x59, 0x55, 0x59, 0x96, 0xA5, 0x58, 0x81, 0x2A,
+						0x28, 0xA0, 0xA2, 0xAA, 0x56, 0x99, 0xAA, 0x5A, 0x55,
+						0x55, 0x50, 0x91, 0xAA, 0xAA, 0x42, 0x56, 0x55, 0x65,
+						0x65, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x59,
+						0x56, 0xA5, 0x54, 0x01, 0x20, 0x64, 0xA1, 0xA9, 0xAA,
+						0xAA, 0xAA, 0x05, 0x5A, 0x55, 0x55, 0xA5, 0xAA, 0x06,
+						0x00,
+					},
+					{
+						0x52, 0x56, 0x55, 0x69, 0x69, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x59, 0x55, 0x59, 0x56, 0xA5, 0x14, 0x01, 0x68,
+						0x69, 0xA1, 0xAA, 0x42, 0xAA, 0x65, 0x05, 0x5A, 0x55,
+						0x55, 0x55, 0x55, 0xAA, 0xAA, 0x4A, 0x56, 0x95, 0x5A,
+						0x59, 0xA5, 0x96, 0x59, 0x6A, 0xA9, 0x95, 0x5A, 0x55,
+						0x55, 0xA5, 0x5A, 0x94, 0x5A, 0x59, 0xA1, 0xA9, 0x6A,
+						0xAA, 0xAA, 0xAA, 0x5A, 0x55, 0x55, 0x55, 0x55, 0x95,
+						0xAA,
+					},
+					{
+						0x54, 0x54, 0x55, 0x59, 0x59, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x59, 0x55, 0x55, 0x55, 0xA5, 0x04, 0x54, 0x09,
+						0x08, 0xA0, 0xAA, 0x82, 0x95, 0xA6, 0x05, 0x5A, 0x55,
+						0x55, 0xAA, 0x6A, 0x55, 0x55, 0x51, 0x55, 0x55, 0x59,
+						0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x55,
+						0x56, 0xA5, 0x14, 0x55, 0x49, 0x59, 0xA0, 0xAA, 0x96,
+						0xAA, 0x96, 0x05, 0x5A, 0x55, 0x55, 0x96, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x50, 0x55, 0x55, 0x59, 0x59, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x54, 0x01, 0x58,
+						0x59, 0x51, 0xAA, 0x55, 0x55, 0x55, 0x05, 0x5A, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x52, 0x56, 0x55, 0x55,
+						0x55, 0x95, 0x5A, 0x55, 0x55, 0x55, 0x55, 0x55, 0x65,
+						0x55, 0x55, 0xA6, 0x55, 0x95, 0x8A, 0x6A, 0x05, 0x88,
+						0x55, 0x55, 0xAA, 0x5A, 0x55, 0x55, 0x5A, 0xA9, 0xAA,
+						0xAA,
+					},
+					{
+						0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x51, 0x00, 0x80, 0x6A, 0x55, 0x15,
+						0x00, 0x40, 0x55, 0x55, 0x55, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x96, 0x59, 0x95, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x66, 0x55, 0x55, 0x51,
+						0x00, 0x00, 0xA4, 0x55, 0x99, 0x00, 0xA0, 0x55, 0x55,
+						0xA5, 0x55, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x50, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x11, 0x51, 0x55, 0x55, 0x55,
+						0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xA9, 0x02, 0x00, 0x00, 0x40, 0x00, 0x04, 0x55, 0x01,
+						0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x58, 0x55, 0x45, 0x55, 0x59, 0x55, 0x55,
+						0x95, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x01, 0x04, 0x00, 0x41, 0x41, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x50, 0x05, 0x54, 0x55, 0x55,
+						0x55, 0x01, 0x54, 0x55, 0x55, 0x45, 0x41, 0x55, 0x51,
+						0x55, 0x55, 0x55, 0x51, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x65, 0xAA, 0xA6, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x59, 0xA5, 0x55, 0x95, 0x59, 0xA5, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0xA5,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59,
+						0xA5, 0x55, 0x95, 0x59, 0xA5, 0x55, 0x55, 0x55, 0x95,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x59, 0xA5, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x95, 0x02, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0xA9, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0xA5, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0x55,
+						0xA5,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0xA9, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA9,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x05, 0xA4, 0xAA, 0x6A, 0x55,
+						0x55, 0x55, 0x55, 0x05, 0x95, 0xAA, 0xAA, 0x55, 0x55,
+						0x55, 0x55, 0x05, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55,
+						0x59, 0x09, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x10, 0x00, 0x50, 0x55, 0x45, 0x01, 0x00, 0x00, 0x55,
+						0x55, 0xA1, 0x55, 0x55, 0xA5, 0xAA, 0x55, 0x55, 0xA5,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x15, 0x00, 0x55, 0x55, 0xA5, 0xAA, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0xA9, 0xAA, 0x55, 0x41, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x91, 0xAA, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x40,
+						0x15, 0x54, 0xAA, 0x45, 0x55, 0x01, 0xAA, 0xA9, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xA5, 0x55, 0xA9, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xAA, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0xAA, 0x55, 0x55,
+						0x95, 0x5A, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x14, 0x5A, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x45, 0x00, 0x80, 0x44, 0x01, 0x00,
+						0x54, 0x15, 0x00, 0x00, 0x28, 0x55, 0x55, 0xA5, 0xAA,
+						0x55, 0x55, 0xA5, 0xAA, 0x55, 0x55, 0x55, 0xA5, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x04, 0x40, 0x54, 0x45, 0x55,
+						0x55, 0xA9, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15,
+						0x00, 0x00, 0x55, 0x55, 0x95, 0x50, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x05, 0x50, 0x10, 0x50, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x45, 0x50, 0x11, 0x50, 0xAA, 0xAA,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x00, 0x00, 0x05, 0x6A, 0x55, 0x55, 0x55,
+						0xA5, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA9, 0xAA,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x95, 0x56, 0x55, 0x55, 0xAA, 0xAA, 0x40, 0x00,
+						0x00, 0x00, 0x04, 0x00, 0x54, 0x51, 0x55, 0x54, 0x90,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0x55, 0xA5, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA5,
+						0x55, 0xA5, 0x55, 0x55, 0x66, 0x66, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0xA5, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x59, 0x55, 0x55, 0x55, 0x59, 0x55, 0x55, 0x55, 0x5A,
+						0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x5A, 0x59, 0x55,
+						0x95,
+					},
+					{
+						0x55, 0x55, 0x15, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x05, 0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x08, 0x00,
+						0x00, 0xA5, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+						0x55, 0x55, 0x55, 0xA9, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0xA9, 0xAA, 0xAA, 0xAA, 0x00, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA8, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xAA,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0x55, 0x55,
+						0x55, 0x69, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0xA9, 0x56, 0x96, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x95, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55,
+						0x95, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x69,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x5A, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x95, 0x55, 0x55, 0x55, 0x55,
+						0x95, 0x55, 0x55, 0x55, 0x59, 0x55, 0xA5, 0x55, 0x55,
+						0x55, 0x55, 0x69, 0x55, 0x5A, 0x55, 0x65, 0x55, 0x56,
+						0x55, 0x55, 0x55, 0x55, 0x65, 0x55, 0xA5, 0x59, 0x65,
+						0x59,
+					},
+					{
+						0x55, 0x59, 0xA5, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x66, 0x95, 0x9A, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0xA9, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x56,
+						0x55, 0x55, 0x95, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x56, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x56, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x5A, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x50, 0xAA, 0x56,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x65, 0xAA, 0xA6, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xAA,
+						0x6A, 0xA9, 0xAA, 0xAA, 0x2A, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x95, 0xAA, 0xAA, 0x55, 0x95, 0x55, 0x95, 0x55,
+						0x95, 0x55, 0x95, 0x55, 0x95, 0x55, 0x95, 0x55, 0x95,
+						0x55, 0x95, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0x0A, 0xA0, 0xAA, 0xAA, 0xAA, 0x6A, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0x82, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0x55, 0x55, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x15, 0x40, 0x00, 0x00, 0x50, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x05, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x50, 0x55, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xAA, 0x65, 0x56,
+						0xA5, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x5A, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x45, 0x45, 0x15, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x41, 0x55, 0xA8, 0x55, 0x55, 0xA5, 0xAA, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0xA0, 0xAA, 0x5A, 0x55, 0x55,
+						0xA5, 0xAA, 0x00, 0x00, 0x00, 0x00, 0x50, 0x55, 0x55,
+						0x15,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x05, 0x00, 0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15,
+						0x00, 0x00, 0x50, 0xAA, 0xAA, 0x6A, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x40, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15,
+						0x05, 0x50, 0x50, 0x55, 0x55, 0x55, 0x65, 0x55, 0x55,
+						0xA5, 0x5A, 0x55, 0x51, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x95,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x01, 0x40, 0x41, 0x81, 0xAA, 0xAA, 0x15, 0x55,
+						0x55, 0xA4, 0x55, 0x55, 0xA5, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x54, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x04,
+						0x14, 0x54, 0x05, 0x91, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0x6A, 0x55, 0x55, 0x55, 0x55, 0x50, 0x55, 0x85, 0xAA,
+						0xAA,
+					},
+					{
+						0x56, 0x95, 0x56, 0x95, 0x56, 0x95, 0xAA, 0xAA, 0x55,
+						0x95, 0x55, 0x95, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x51, 0x54, 0xA1, 0x55, 0x55, 0xA5,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x95, 0x6A, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xAA,
+					},
+					{
+						0x55, 0x95, 0xAA, 0xAA, 0x6A, 0x55, 0xAA, 0x46, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x95, 0x55, 0x99, 0x65, 0x59,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x95, 0xAA, 0xAA, 0xAA, 0x6A, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x5A, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0xAA, 0x6A, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x00, 0x00, 0x00, 0x00, 0xAA, 0xAA, 0xAA, 0xAA, 0x00,
+						0x00, 0x00, 0x00, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0x55, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x29,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x56, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x95, 0x5A, 0x55, 0x5A, 0x55, 0x5A, 0x55,
+						0x5A, 0xA9, 0xAA, 0xAA, 0x55, 0x95, 0xAA, 0xAA, 0x02,
+						0xA5,
+					},
+					{
+						0x55, 0x55, 0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x95, 0x55, 0x55, 0x55, 0x55, 0x95, 0x65, 0x55, 0x55,
+						0x55, 0xA5, 0x55, 0x55, 0x55, 0xA5, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+						0xAA,
+					},
+					{
+						0x95, 0x6A, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x6A, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+						0x55, 0x55, 0x55, 0xA9, 0xA9, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xA1,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0xA9, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA9, 0xAA,
+						0xAA, 0xAA, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xAA, 0xAA, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x95, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x05, 0x80, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0xAA, 0x55, 0x55, 0x55, 0xA5,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0xA5, 0x55, 0x55, 0xA5, 0xAA, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xAA,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xAA, 0xAA,
+						0x6A, 0x55, 0x55, 0x95, 0x55, 0x55, 0x55, 0x95, 0x55,
+						0x95, 0x65, 0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x65,
+						0x55, 0x65, 0xA9, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x95, 0xAA, 0xAA, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0xA5, 0xAA, 0xAA, 0x55, 0x55, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x65, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59,
+						0x55, 0x95, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0xA5, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x65, 0xA9, 0x69, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x95, 0xAA, 0x6A, 0x55, 0x55, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x95, 0xA5, 0x6A,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x6A, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0x6A, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x5A, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x01, 0x82, 0xAA, 0x00, 0x55, 0x56, 0x56, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0xA5, 0x80, 0x2A, 0x55, 0x55,
+						0xA9, 0xAA, 0x55, 0x55, 0xA9, 0xAA, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x81, 0x6A, 0x55, 0x55, 0x95, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0xA5, 0x56, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0xA5, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x95, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xA5, 0xAA, 0x56, 0xA9, 0xAA, 0xAA, 0x56, 0x55, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xA9, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+						0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xAA, 0x5A,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x00, 0xAA, 0xAA, 0x55, 0x55, 0xA5, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x95, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x25, 0xA4, 0xA5,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05,
+						0x00, 0x00, 0x54, 0x55, 0xA5, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0x55, 0x55, 0x55, 0x55, 0x05, 0x50, 0xA5, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xAA,
+						0xAA,
+					},
+					{
+						0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x00, 0x00, 0x40,
+						0x55, 0xA5, 0x5A, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x14, 0xA4, 0xAA, 0x2A, 0x50, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15,
+						0x40, 0x41, 0x51, 0x85, 0xAA, 0xAA, 0xA2, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0xA9, 0xAA, 0x55, 0x55, 0xA5,
+						0xAA,
+					},
+					{
+						0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x15, 0x00, 0x01, 0x00, 0x58, 0x55, 0x55, 0x55, 0x55,
+						0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x15, 0x95, 0xAA, 0xAA, 0x50, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x05, 0x00, 0x40, 0x55, 0x55, 0x01, 0x14, 0x55, 0x55,
+						0x55, 0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0xA9, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x15, 0x50, 0x04, 0x55, 0x85, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x95, 0x59, 0x65,
+						0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0xA5, 0xAA, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x15, 0x15, 0x00, 0x80, 0xAA, 0x55, 0x55, 0xA5,
+						0xAA,
+					},
+					{
+						0x50, 0x56, 0x55, 0x69, 0x69, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x59, 0x55, 0x59, 0x56, 0x25, 0x54, 0x54, 0x69,
+						0x69, 0xA5, 0xA9, 0x6A, 0xAA, 0x56, 0x55, 0x0A, 0x00,
+						0xA8, 0x00, 0xA8, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x00, 0x05, 0x44,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x46, 0xA5, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15,
+						0x00, 0x44, 0x15, 0x04, 0x55, 0xAA, 0xAA, 0x55, 0x55,
+						0xA5, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05,
+						0xA0, 0x55, 0x10, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0xA0, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x15, 0x00, 0x40, 0x11, 0x54, 0xA9,
+						0xAA, 0xAA, 0x55, 0x55, 0xA5, 0xAA, 0x55, 0x55, 0x55,
+						0xA9, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x51, 0x00,
+						0x10, 0xA5, 0xAA, 0x55, 0x55, 0xA5, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x02, 0x05,
+						0x10, 0x00, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x15, 0x00, 0x00, 0x41, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xAA, 0xAA,
+						0x6A,
+					},
+					{
+						0x55, 0x95, 0xA6, 0x55, 0x55, 0x96, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x65, 0x29, 0x44, 0x15, 0x95,
+						0xAA, 0xAA, 0x55, 0x55, 0xA5, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x5A, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00,
+						0x0A, 0x55, 0x54, 0xA9, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x01, 0x00, 0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x15, 0x00, 0x14, 0x40, 0x55, 0x15,
+						0xAA, 0xAA, 0x01, 0x40, 0x01, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00,
+						0x00, 0x40, 0x50, 0x55, 0x95, 0xAA, 0xAA, 0xAA, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA9,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x00, 0x80, 0x00, 0x10, 0x55, 0xA5,
+						0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xA9, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x04,
+						0x81, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x95, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x01, 0x80, 0x8A, 0x20, 0x00, 0x10,
+						0xAA, 0xAA, 0x55, 0x55, 0xA5, 0xAA, 0x55, 0x65, 0x59,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+						0x60, 0x11, 0xA9, 0xAA, 0x55, 0x55, 0xA5, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x15, 0x54, 0xA9,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xA9,
+						0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0xAA, 0xAA,
+						0x6A,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0xA5, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x95, 0x55, 0xA9, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x95, 0x00, 0x00, 0xA8, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0xA9, 0xAA, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x55, 0x55, 0xA5,
+						0x5A, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x95, 0x55, 0x55, 0xA5, 0xAA, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0x00, 0xA4, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x00, 0x40, 0x55, 0x55, 0x55, 0xA5,
+						0xAA, 0xAA, 0x55, 0x55, 0x65, 0x55, 0x65, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0xAA, 0x56, 0x55, 0x55, 0x55, 0x55,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x95, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x95, 0x2A, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xAA, 0x2A,
+						0x40, 0x55, 0x55, 0x55, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xA8, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+						0xAA, 0x55, 0x55, 0x55, 0xA9, 0x55, 0x55, 0xA9, 0xAA,
+						0x55, 0x55, 0xA5, 0x41, 0x00, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0xA0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+						0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x95, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x50,
+						0x55, 0x15, 0x00, 0x00, 0x00, 0x40, 0x01, 0x00, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x50, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x95, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0xA4,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x95, 0xAA, 0xAA, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0xA9, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x59, 0x9A, 0x96, 0x56, 0x59, 0x55,
+						0x55, 0x65, 0x56, 0x55, 0x56, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x65, 0x95, 0x56, 0x55, 0x59, 0x55, 0x59, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x65, 0x95, 0x55, 0x99,
+						0x5A, 0x55, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x5A, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x40, 0x15, 0x00, 0x00, 0x00,
+						0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+						0x54, 0x55, 0x51, 0x55, 0x55, 0x55, 0x54, 0x55, 0xAA,
+						0xAA, 0xAA, 0x2A, 0x00, 0x02, 0x00, 0x00, 0x00, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x28, 0x00, 0x20,
+						0x08, 0x80, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0xA9, 0x00, 0x40, 0x55, 0xA5, 0x55, 0x55,
+						0xA5, 0x5A, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x85, 0xAA,
+						0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x55, 0x55, 0xA5,
+						0x6A,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0x55, 0x95, 0x55, 0x96, 0x55, 0x55, 0x55,
+						0x95,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x69, 0x55, 0x55, 0x00, 0x80,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00,
+						0x40, 0xAA, 0x55, 0x55, 0xA5, 0x5A, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xA9, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x96,
+						0x69, 0x56, 0x55, 0x95, 0x55, 0x66, 0xAA, 0x9A, 0x6A,
+						0x66, 0x56, 0x96, 0x69, 0x66, 0x66, 0x96, 0x69, 0x95,
+						0x55, 0x95, 0x55, 0x56, 0x99, 0x55, 0x55, 0x65, 0x55,
+						0x55, 0x55, 0x55, 0xAA, 0x56, 0x56, 0x65, 0x55, 0x55,
+						0x55, 0x55, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xA5, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x95, 0x56,
+						0x55, 0x55, 0x55, 0x56, 0x55, 0x55, 0x95, 0x56, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x65,
+						0xA9, 0xAA, 0x6A, 0x55, 0x55, 0x55, 0x55, 0xA5, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0x5A, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x56,
+						0x55, 0x55, 0xA9, 0xAA, 0x9A, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xA6, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0x55, 0x55, 0x55, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x6A, 0x95, 0xAA, 0x55,
+						0x55, 0x55, 0xAA, 0xAA, 0xAA, 0xAA, 0x56, 0x56, 0xAA,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x6A, 0xA6, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0x96,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x5A, 0x55, 0x55,
+						0x95, 0x6A, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55,
+						0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x69, 0x55, 0x55, 0x55, 0x56, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+						0xAA,
+					},
+					{
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0x5A, 0x55, 0x56, 0x6A, 0xA9,
+						0xAA, 0xAA, 0x55, 0x55, 0x95, 0xAA, 0x55, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xA9, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0xAA, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0xAA, 0xAA, 0x55, 0x55, 0xA5, 0xAA, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xAA, 0xAA,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xA5, 0xA5,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x6A, 0xAA, 0xAA, 0x9A,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55,
+						0xA5, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+						0xAA,
+					},
+					{
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x95, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+						0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xAA, 0xAA, 0xAA,
+						0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0xA5,
+						0xAA,
+					},
+				};
+				return table;
+			}
+		};
+	}   // namespace detail
+CPP_SGR_END_NAMESPACE
+
+#endif /* end of include guard: CPP_SGR_WIDTH_TABLE_HPP */
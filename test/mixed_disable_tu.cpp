@@ -0,0 +1,19 @@
+#define CPP_SGR_DISABLE
+#include <cpp_sgr/sgr.hpp>
+#include <cpp_sgr/styled_buffer.hpp>
+
+#include <sstream>
+#include <string>
+
+using namespace cpp_sgr;
+
+std::string render_disabled()
+{
+  std::ostringstream stream;
+  stream << bold << "a" << styled(red_fg, 1);
+
+  styled_buffer buffer;
+  buffer.append(underline, "b");
+  stream << buffer;
+  return stream.str();
+}
@@ -0,0 +1,35 @@
+# Check that no translation unit of the multi_tu program has static
+# initializers, and report the startup time of the program.
+#
+# Run in script mode with OBJDUMP, OBJECT_LIST (a file listing the objects)
+# and PROGRAM defined.
+
+file(READ ${OBJECT_LIST} objects)
+
+set(failed FALSE)
+foreach(object ${objects})
+  execute_process(COMMAND ${OBJDUMP} -h ${object} OUTPUT_VARIABLE sections)
+  if(sections MATCHES "\\.(init_array|ctors)")
+    message(SEND_ERROR "${object} has static initializers")
+    set(failed TRUE)
+  endif()
+endforeach()
+if(failed)
+  return()
+endif()
+
+# Timing relies on sub-second string(TIMESTAMP), added in CMake 3.23
+if(NOT CMAKE_VERSION VERSION_LESS 3.23)
+  set(runs 20)
+  string(TIMESTAMP start "%s%f" UTC)
+  foreach(i RANGE 1 ${runs})
+    execute_process(COMMAND ${PROGRAM} RESULT_VARIABLE result)
+    if(result)
+      message(FATAL_ERROR "${PROGRAM} failed")
+    endif()
+  endforeach()
+  string(TIMESTAMP end "%s%f" UTC)
+  math(EXPR average "(${end} - ${start}) / ${runs}")
+  list(LENGTH objects count)
+  message("Startup of ${count} translation units: ${average} us per run")
+endif()
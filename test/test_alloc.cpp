@@ -0,0 +1,199 @@
+#include <cpp_sgr/sgr.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+
+using namespace cpp_sgr;
+
+static unsigned long allocations = 0;
+
+void * operator new(std::size_t size)
+{
+  ++allocations;
+  if(void * p = std::malloc(size ? size : 1))
+  {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+class null_buffer : public std::streambuf
+{
+protected:
+  std::streamsize xsputn(const char *, std::streamsize count) override
+  {
+    return count;
+  }
+
+  int_type overflow(int_type c) override
+  {
+    return traits_type::not_eof(c);
+  }
+};
+
+static null_buffer discard;
+static std::ostream plain(&discard);
+static std::ostream tracked(&discard);
+static std::ostream atomic(&discard);
+static std::ostream quantizing(&discard);
+static std::string text;
+static char buffer[style::MAX_RENDERED_SIZE];
+static volatile std::size_t observed;
+
+static const sgr wide =
+  bold + color::fg(255, 255, 255) + color::bg(255, 255, 255);
+
+/**
+ * Allocations expected per call of a public entry point, once warmed up.
+ */
+static const struct
+{
+  const char * name;
+  unsigned long expected;
+  void (*run)(unsigned);
+} entries[] = {
+  {"operator+", 0, [](unsigned i) {
+    observed = (sgr(sgr::SGRCode(i % 10)) + red_fg).getStyle().attributeMask();
+  }},
+  {"operator,", 0, [](unsigned i) {
+    observed = (sgr(sgr::SGRCode(i % 10)), red_fg).getStyle().attributeMask();
+  }},
+  {"color::fg(ANSIColor)", 0, [](unsigned i) {
+    observed = color::fg(color::ANSIColor(30 + i % 8)).getStyle()
+      .foregroundColor();
+  }},
+  {"color::fg256", 0, [](unsigned i) {
+    observed = color::fg256(int(i & 0xFF)).getStyle().foregroundColor();
+  }},
+  {"color::fg(r, g, b)", 0, [](unsigned i) {
+    observed = color::fg(int(i & 0xFF), 1, 2).getStyle().foregroundColor();
+  }},
+  {"color::bg(rgb)", 0, [](unsigned i) {
+    observed = color::bg(rgb{uint8_t(i), 1, 2}).getStyle().backgroundColor();
+  }},
+  {"sgr::toString short", 0, [](unsigned) {
+    observed = bold.toString().size();
+  }},
+  {"sgr::toString long", 1, [](unsigned) {
+    observed = wide.toString().size();
+  }},
+  {"sgr::writeTo", 0, [](unsigned) {
+    observed = std::size_t(wide.writeTo(buffer) - buffer);
+  }},
+  {"sgr::appendTo", 0, [](unsigned) {
+    text.clear();
+    wide.appendTo(text);
+    observed = text.size();
+  }},
+  {"style::render", 0, [](unsigned) {
+    observed = wide.getStyle().render().size();
+  }},
+  {"style::writeTransition", 0, [](unsigned) {
+    observed = std::size_t(style::writeTransition(
+      bold.getStyle(), wide.getStyle(), buffer) - buffer);
+  }},
+  {"style::applyParams", 0, [](unsigned i) {
+    const int params[] = {1, 38, 2, int(i & 0xFF), 2, 3};
+    observed = style().applyParams(params, 6).foregroundColor();
+  }},
+  {"static_sgr::toString", 0, [](unsigned) {
+    observed = static_sgr<1, 31>().toString().size();
+  }},
+  {"sgr::quantized", 0, [](unsigned) {
+    observed = wide.quantized(ANSI_16).getStyle().foregroundColor();
+  }},
+  {"quantize", 0, [](unsigned) {
+    style styles[] = {wide.getStyle(), bold.getStyle()};
+    quantize(styles, 2, INDEXED_256);
+    observed = styles[0].foregroundColor();
+  }},
+  {"nearest_indexed", 0, [](unsigned i) {
+    observed = nearest_indexed(rgb{uint8_t(i), 7, 9});
+  }},
+  {"nearest_ansi", 0, [](unsigned i) {
+    observed = nearest_ansi(rgb{uint8_t(i), 7, 9});
+  }},
+  {"ostream << sgr", 0, [](unsigned) {
+    plain << bold << 'x';
+  }},
+  {"ostream << sgr chain", 0, [](unsigned i) {
+    plain << bold << "x" << red_fg << i << reset << 'y';
+  }},
+  {"ostream << static_sgr", 0, [](unsigned) {
+    plain << static_sgr<1, 31>() << 'x';
+  }},
+  {"ostream << reset", 0, [](unsigned) {
+    plain << reset << 'x';
+  }},
+  {"tracked ostream << sgr", 0, [](unsigned i) {
+    tracked << (i & 1 ? bold : red_fg) << 'x';
+  }},
+  {"atomic ostream << sgr", 0, [](unsigned i) {
+    atomic << bold << "x" << i << red_fg << 'y';
+  }},
+  {"quantized ostream << sgr", 0, [](unsigned i) {
+    quantizing << color::fg(int(i & 0xFF), 1, 2) << 'x';
+  }},
+  {"ostream << styled", 0, [](unsigned i) {
+    plain << styled(red_fg, i);
+  }},
+  {"ostream << styled variadic", 0, [](unsigned i) {
+    plain << styled(bold + red_fg, "i=", i, ' ');
+  }},
+  {"tracked ostream << styled", 0, [](unsigned i) {
+    tracked << styled(i & 1 ? bold : red_fg, i);
+  }},
+  {"sgr_ostream_wrapper move", 0, [](unsigned) {
+    sgr_ostream_wrapper wrapper(plain);
+    sgr_ostream_wrapper moved(std::move(wrapper));
+    moved << 'x';
+  }},
+  {"track_style", 0, [](unsigned i) {
+    track_style(plain, i & 1);
+  }},
+};
+
+int main()
+{
+  text.reserve(style::MAX_RENDERED_SIZE);
+  track_style(tracked);
+  atomic_chains(atomic);
+  color_depth(quantizing, ANSI_16);
+
+  const unsigned calls = 100;
+  int failures = 0;
+  for(const auto & entry : entries)
+  {
+    // Warm up lazily built tables and per-stream storage
+    entry.run(0);
+
+    const unsigned long before = allocations;
+    for(unsigned i = 0; i < calls; ++i)
+    {
+      entry.run(i);
+    }
+    const unsigned long counted = allocations - before;
+
+    if(counted != entry.expected * calls)
+    {
+      std::fprintf(stderr, "%s: %lu allocations in %u calls, expected %lu\n",
+                   entry.name, counted, calls, entry.expected * calls);
+      ++failures;
+    }
+  }
+
+  return failures == 0 ? 0 : -1;
+}
@@ -0,0 +1,207 @@
+#include <cpp_sgr/async_sink.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cpp_sgr;
+
+static const int thread_count = 4;
+static const int record_count = 2000;
+
+static std::string read_back(std::FILE * file)
+{
+  std::rewind(file);
+  std::string result;
+  char chunk[4096];
+  std::size_t count;
+  while((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+  {
+    result.append(chunk, count);
+  }
+  return result;
+}
+
+// Output recording each write as a chunk, slowly enough that a producer
+// outpaces the background thread
+class slow_buffer : public std::streambuf
+{
+public:
+  std::vector<std::string> chunks;
+
+protected:
+  std::streamsize xsputn(const char * s, std::streamsize count) override
+  {
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    chunks.emplace_back(s, static_cast<std::size_t>(count));
+    return count;
+  }
+
+  int_type overflow(int_type c) override
+  {
+    if(!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+      chunks.emplace_back(1, traits_type::to_char_type(c));
+    }
+    return traits_type::not_eof(c);
+  }
+};
+
+static void produce(async_sink & sink, const int id)
+{
+  const sgr styles[] = {red_fg, green_fg + bold, color::fg(1, 2, 3), reset};
+  for(int i = 0; i < record_count; ++i)
+  {
+    sink.write(styles[i % 4], "t" + std::to_string(id) + ":" +
+                                std::to_string(i) + "\n");
+  }
+}
+
+int main()
+{
+  // Blocking sink: every record arrives intact, output ends with a reset
+  std::FILE * file = std::tmpfile();
+  if(!file)
+  {
+    return -1;
+  }
+
+  {
+    async_sink sink(file, 64, async_sink::BLOCK, 32);
+    std::vector<std::thread> producers;
+    for(int id = 0; id < thread_count; ++id)
+    {
+      producers.emplace_back(produce, std::ref(sink), id);
+    }
+    for(std::thread & producer : producers)
+    {
+      producer.join();
+    }
+    sink.flush();
+    if(sink.failed() != 0)
+    {
+      return -1;
+    }
+  }
+
+  const std::string output = read_back(file);
+  std::fclose(file);
+
+  for(int id = 0; id < thread_count; ++id)
+  {
+    for(int i = 0; i < record_count; i += 97)
+    {
+      const std::string record =
+        "t" + std::to_string(id) + ":" + std::to_string(i) + "\n";
+      if(output.find(record) == std::string::npos)
+      {
+        return -1;
+      }
+    }
+  }
+  if(output.size() < 4 || output.compare(output.size() - 4, 4, "\x1b[0m"))
+  {
+    return -1;
+  }
+
+  // Dropping sink: every record is either written or counted as dropped
+  std::ostringstream stream;
+  std::size_t dropped;
+  {
+    async_sink sink(stream, 4, async_sink::DROP);
+    produce(sink, 0);
+    sink.flush();
+    dropped = sink.dropped();
+  }
+
+  std::size_t lines = 0;
+  for(char c : stream.str())
+  {
+    lines += c == '\n';
+  }
+  if(lines + dropped != record_count)
+  {
+    return -1;
+  }
+
+  // Slow output: while producers outpace the background thread, batches
+  // stay within the ring buffer's capacity and each producer's records
+  // still arrive in order
+  slow_buffer slow;
+  {
+    std::ostream slow_stream(&slow);
+    async_sink sink(slow_stream, 8, async_sink::BLOCK);
+    std::vector<std::thread> producers;
+    for(int id = 0; id < thread_count; ++id)
+    {
+      producers.emplace_back([&sink, id] {
+        for(int i = 0; i < record_count; ++i)
+        {
+          sink.write(std::to_string(id) + ":" + std::to_string(i) + "\n");
+        }
+      });
+    }
+    for(std::thread & producer : producers)
+    {
+      producer.join();
+    }
+  }
+
+  std::string ordered;
+  for(const std::string & chunk : slow.chunks)
+  {
+    std::size_t chunk_lines = 0;
+    for(char c : chunk)
+    {
+      chunk_lines += c == '\n';
+    }
+    if(chunk_lines > 8)
+    {
+      return -1;
+    }
+    ordered += chunk;
+  }
+  if(ordered.size() < 4 ||
+     ordered.compare(ordered.size() - 4, 4, "\x1b[0m"))
+  {
+    return -1;
+  }
+
+  std::vector<int> next(thread_count, 0);
+  std::istringstream records(ordered.substr(0, ordered.size() - 4));
+  std::string record;
+  while(std::getline(records, record))
+  {
+    const std::size_t colon = record.find(':');
+    const int id = std::stoi(record.substr(0, colon));
+    if(std::stoi(record.substr(colon + 1)) != next[id]++)
+    {
+      return -1;
+    }
+  }
+  for(int id = 0; id < thread_count; ++id)
+  {
+    if(next[id] != record_count)
+    {
+      return -1;
+    }
+  }
+
+  // Failing output: records lost to write errors are counted
+  {
+    async_sink sink(-1);
+    sink.write(bold, "lost");
+    sink.write("lost");
+    sink.flush();
+    if(sink.failed() != 2)
+    {
+      return -1;
+    }
+  }
+
+  return 0;
+}
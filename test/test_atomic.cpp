@@ -0,0 +1,89 @@
+#include <cpp_sgr/sgr.hpp>
+
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cpp_sgr;
+
+// Records every write it receives as a separate chunk
+class chunk_buffer : public std::streambuf
+{
+public:
+  std::vector<std::string> chunks;
+
+protected:
+  int_type overflow(int_type c) override
+  {
+    const char ch = traits_type::to_char_type(c);
+    xsputn(&ch, 1);
+    return c;
+  }
+
+  std::streamsize xsputn(const char * data, std::streamsize count) override
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    chunks.emplace_back(data, static_cast<std::size_t>(count));
+    return count;
+  }
+
+private:
+  std::mutex mutex;
+};
+
+static const int chain_count = 500;
+
+int main()
+{
+  chunk_buffer buffer;
+  std::ostream stream(&buffer);
+  atomic_chains(stream);
+
+  std::vector<std::thread> threads;
+  for(int id = 0; id < 4; ++id)
+  {
+    threads.emplace_back([&stream, id] {
+      for(int i = 0; i < chain_count; ++i)
+      {
+        stream << bold << "thread " << id << red_fg << " line";
+      }
+    });
+  }
+  for(std::thread & thread : threads)
+  {
+    thread.join();
+  }
+
+  if(buffer.chunks.size() != 4 * chain_count)
+  {
+    return -1;
+  }
+  for(const std::string & chunk : buffer.chunks)
+  {
+    if(chunk.size() != 26 || chunk.compare(0, 11, "\x1b[1mthread ") ||
+       chunk.compare(12, 14, "\x1b[31m line\x1b[0m"))
+    {
+      return -1;
+    }
+  }
+
+  // Formatting state carries over into the staged chain, but changes made
+  // within it stay there
+  buffer.chunks.clear();
+  stream << std::hex << bold << 255 << std::dec;
+  stream << 255;
+  std::string rest;
+  for(std::size_t i = 1; i < buffer.chunks.size(); ++i)
+  {
+    rest += buffer.chunks[i];
+  }
+  if(buffer.chunks[0] != "\x1b[1mff\x1b[0m" || rest != "ff")
+  {
+    return -1;
+  }
+
+  return 0;
+}
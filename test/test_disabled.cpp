@@ -0,0 +1,66 @@
+#define CPP_SGR_DISABLE
+#include <cpp_sgr/sgr.hpp>
+#include <cpp_sgr/styled_buffer.hpp>
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+using namespace cpp_sgr;
+
+// Patterns are assembled at run time from one int per character, so their
+// bytes are never adjacent in the binary being searched
+template<std::size_t N>
+static std::string assemble(const volatile int (&codes)[N])
+{
+  std::string result;
+  for(std::size_t i = 0; i < N; ++i)
+  {
+    result += static_cast<char>(codes[i]);
+  }
+  return result;
+}
+
+int main(int, char ** argv)
+{
+  std::ostringstream stream;
+  stream << bold << "plain " << (red_fg, underline) << 42;
+  stream << color::fg(1, 2, 3) << static_sgr<sgr::BOLD>() << " text";
+  if(stream.str() != "plain 42 text")
+  {
+    return -1;
+  }
+
+  styled_buffer buffer;
+  buffer.append(bold, "a").append(color::bg256(7), "b");
+  if(buffer.str() != "ab")
+  {
+    return -1;
+  }
+
+  // Neither escape sequences nor the wrapper made it into the binary
+  std::ifstream file(argv[0], std::ios::binary);
+  const std::string binary((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+  if(binary.empty())
+  {
+    return -1;
+  }
+
+  static const volatile int escape_codes[] = {'\x1b', '['};
+  static const volatile int wrapper_codes[] = {
+    's', 'g', 'r', '_', 'o', 's', 't', 'r', 'e', 'a',
+    'm', '_', 'w', 'r', 'a', 'p', 'p', 'e', 'r'};
+  const std::string escape = assemble(escape_codes);
+  const std::string wrapper = assemble(wrapper_codes);
+
+  if(binary.find(escape) != std::string::npos ||
+     binary.find(wrapper) != std::string::npos)
+  {
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include <cpp_sgr/fd_writer.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace cpp_sgr;
+
+static std::string read_all(const int fd)
+{
+  std::string result;
+  char chunk[4096];
+  ssize_t count;
+  while((count = ::read(fd, chunk, sizeof(chunk))) > 0)
+  {
+    result.append(chunk, static_cast<std::size_t>(count));
+  }
+  return result;
+}
+
+// Write through a pipe, reading concurrently so large batches cannot block
+template<class Function>
+static std::string capture(Function function)
+{
+  int fds[2];
+  if(::pipe(fds) != 0)
+  {
+    return "pipe failed";
+  }
+  std::string result;
+  std::thread reader([&result, &fds]() { result = read_all(fds[0]); });
+  function(fds[1]);
+  ::close(fds[1]);
+  reader.join();
+  ::close(fds[0]);
+  return result;
+}
+
+int main()
+{
+  // Partially written regions are skipped or shrunk
+  char a[] = "abc", b[] = "de", c[] = "f";
+  detail::io_vector vectors[] = {{a, 3}, {b, 2}, {c, 1}};
+  detail::io_vector * next = vectors;
+  int count = 3;
+  detail::advance_vectors(next, count, 4);
+  if(count != 2 || next != vectors + 1 || next->iov_len != 1 ||
+     static_cast<char *>(next->iov_base) != b + 1)
+  {
+    return -1;
+  }
+  detail::advance_vectors(next, count, 2);
+  if(count != 0)
+  {
+    return -1;
+  }
+
+  const std::string single = capture([](int fd) {
+    fd_writer writer(fd);
+    writer.write(bold + red_fg, "error");
+    writer.write(reset, std::string(": plain\n"));
+  });
+  if(single != "\x1b[1;31merror\x1b[0m: plain\n")
+  {
+    return -1;
+  }
+
+  const std::string quantized = capture([](int fd) {
+    fd_writer ansi(fd, ANSI_16);
+    ansi.write(color::fg(250, 10, 10), "x");
+    fd_writer plain(fd, PLAIN);
+    plain.write(color::fg(250, 10, 10), "y");
+  });
+  if(quantized != "\x1b[91mx\x1b[0my")
+  {
+    return -1;
+  }
+
+  // Batches spanning several writev() calls, mixing plain messages
+  const std::size_t messages = 5000;
+  const std::string payload(100, 'p');
+  std::string expected;
+  std::size_t pending = 0;
+  const std::string batched = capture([&](int fd) {
+    fd_writer writer(fd);
+    for(std::size_t i = 0; i < messages; ++i)
+    {
+      const sgr & s = i % 3 == 0 ? reset : (i % 3 == 1 ? green_fg : underline);
+      if(!writer.queue(s, payload))
+      {
+        return;
+      }
+      expected += s.getStyle().effective().empty() ? payload :
+        s.toString() + payload + "\x1b[0m";
+    }
+    pending = writer.pending();
+  });
+  // Full batches were written on the way, the rest when destroyed
+  if(batched != expected || pending == 0 || pending >= messages)
+  {
+    return -1;
+  }
+
+  // Writing to a closed descriptor fails
+  fd_writer broken(-1);
+  if(broken.write(bold, "x", 1))
+  {
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,38 @@
+#include <cpp_sgr/sgr.hpp>
+
+#include <iomanip>
+#include <regex>
+#include <sstream>
+#include <string>
+
+using namespace cpp_sgr;
+
+int main()
+{
+  // Formatting state set before the chain carries over into it
+  const std::regex chk_regex(R"REGEX(\x1b\[1m00ff a\x1b\[0mff)REGEX");
+
+  std::ostringstream stream;
+
+  stream << std::hex << std::setfill('0') << std::setw(4) << bold << 255
+         << " " << 10;
+  stream << 255;
+
+  if(!std::regex_match(stream.str(), chk_regex))
+  {
+    return -1;
+  }
+
+  // Formatting state changed within the chain does not leak out of it
+  std::ostringstream other;
+
+  other << red_fg << std::hex << std::setfill('*') << 255;
+  other << std::setw(4) << 255;
+
+  if(other.str() != "\x1b[31mff\x1b[0m 255")
+  {
+    return -1;
+  }
+
+  return 0;
+}
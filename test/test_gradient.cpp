@@ -0,0 +1,68 @@
+#include <cpp_sgr/gradient.hpp>
+
+#include <string>
+
+using namespace cpp_sgr;
+
+int main()
+{
+  // Endpoints are exact, midpoints are rounded
+  const gradient red_to_blue(rgb{255, 0, 0}, rgb{0, 0, 255});
+  if(red_to_blue.render("abc") !=
+     "\x1b[38;2;255;0;0ma\x1b[38;2;128;0;128mb\x1b[38;2;0;0;255mc\x1b[0m")
+  {
+    return -1;
+  }
+
+  // Multi-byte glyphs take a single step
+  if(red_to_blue.render("\xc3\xa9x") !=
+     "\x1b[38;2;255;0;0m\xc3\xa9\x1b[38;2;0;0;255mx\x1b[0m")
+  {
+    return -1;
+  }
+
+  // Characters with the same color share an escape sequence
+  const gradient flat(rgb{1, 2, 3}, rgb{1, 2, 3});
+  if(flat.render("aaaa") != "\x1b[38;2;1;2;3maaaa\x1b[0m")
+  {
+    return -1;
+  }
+
+  gradient reds(rgb{255, 0, 0}, rgb{250, 10, 10});
+  reds.setDepth(ANSI_16);
+  if(reds.render("abcdef") != "\x1b[91mabcdef\x1b[0m")
+  {
+    return -1;
+  }
+
+  // Background gradients keep the base style
+  gradient background({rgb{0, 0, 0}, rgb{0, 255, 0}}, false);
+  background.setStyle(bold + red_fg);
+  if(background.render("ab") !=
+     "\x1b[1;31;48;2;0;0;0ma\x1b[48;2;0;255;0mb\x1b[0m")
+  {
+    return -1;
+  }
+
+  // Multi-stop gradients pass through every stop
+  const rgb stops[] = {{0, 0, 0}, {200, 100, 0}, {0, 0, 0}};
+  const gradient tent(stops, 3);
+  rgb colors[5];
+  tent.colors(5, colors);
+  if(colors[0].r != 0 || colors[1].r != 100 || colors[1].g != 50 ||
+     colors[2].r != 200 || colors[2].g != 100 || colors[3].r != 100 ||
+     colors[4].r != 0 || colors[4].g != 0)
+  {
+    return -1;
+  }
+
+  std::string out = "> ";
+  red_to_blue.appendTo(out, "", 0);
+  flat.appendTo(out, "z", 1);
+  if(out != "> \x1b[38;2;1;2;3mz\x1b[0m")
+  {
+    return -1;
+  }
+
+  return 0;
+}
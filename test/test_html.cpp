@@ -0,0 +1,71 @@
+#include <cpp_sgr/html.hpp>
+#include <cpp_sgr/sgr.hpp>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+using namespace cpp_sgr;
+
+int main()
+{
+  std::ostringstream stream;
+  stream << "a<b> & \"c\" 'd'\n";
+  stream << (bold, red_fg) << "x" << "y" << underline << "z";
+  stream << color::fg(255, 128, 0) + color::bg256(17) << "rgb";
+  stream << (strike, overline) << "lines";
+  const std::string input = stream.str();
+
+  const std::string expected =
+    "a&lt;b&gt; &amp; &quot;c&quot; &#39;d&#39;\n"
+    "<span class=\"sgr-1 sgr-fg1\">xy</span>"
+    "<span class=\"sgr-1 sgr-d1 sgr-fg1\">z</span>"
+    "<span class=\"sgr-bg17\" style=\"color:#ff8000;\">rgb</span>"
+    "<span class=\"sgr-d6\">lines</span>";
+
+  if(ansi_to_html(input) != expected)
+  {
+    return -1;
+  }
+
+  // Chunks of every size produce the same HTML
+  for(std::size_t size = 1; size <= input.size(); ++size)
+  {
+    html_converter converter;
+    std::string html;
+    for(std::size_t i = 0; i < input.size(); i += size)
+    {
+      converter.convert(input.data() + i, std::min(size, input.size() - i),
+                        html);
+    }
+    converter.finish(html);
+    if(html != expected)
+    {
+      return -1;
+    }
+  }
+
+  // Long text with special characters at every offset
+  std::string text;
+  std::string escaped;
+  for(int i = 0; i < 200; ++i)
+  {
+    text += std::string(static_cast<std::size_t>(i % 23), 'x') + "<";
+    escaped += std::string(static_cast<std::size_t>(i % 23), 'x') + "&lt;";
+  }
+  if(ansi_to_html(text) != escaped)
+  {
+    return -1;
+  }
+
+  const std::string css = html_converter::stylesheet();
+  if(css.find(".sgr-fg1{color:#cd0000}") == std::string::npos ||
+     css.find(".sgr-bg255{background-color:#eeeeee}") == std::string::npos ||
+     css.find(".sgr-d5{text-decoration:underline overline}") ==
+       std::string::npos)
+  {
+    return -1;
+  }
+
+  return 0;
+}
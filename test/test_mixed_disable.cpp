@@ -0,0 +1,33 @@
+#include <cpp_sgr/sgr.hpp>
+#include <cpp_sgr/styled_buffer.hpp>
+
+#include <sstream>
+#include <string>
+
+using namespace cpp_sgr;
+
+// Defined in a translation unit built with CPP_SGR_DISABLE
+std::string render_disabled();
+
+static std::string render_enabled()
+{
+  std::ostringstream stream;
+  stream << bold << "a" << styled(red_fg, 1);
+
+  styled_buffer buffer;
+  buffer.append(underline, "b");
+  stream << buffer;
+  return stream.str();
+}
+
+int main()
+{
+  // Both configurations keep their own inline functions in one program
+  if(render_disabled() != "a1b" || render_enabled() == "a1b" ||
+     render_enabled().find("\x1b[") == std::string::npos)
+  {
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,44 @@
+#include <cpp_sgr/sgr.hpp>
+
+#include <cstddef>
+#include <cstring>
+
+#define MULTI_TU(i) const cpp_sgr::sgr * multi_tu_##i(char *, std::size_t *);
+#include "multi_tu_list.hpp"
+#undef MULTI_TU
+
+typedef const cpp_sgr::sgr * (*tu_function)(char *, std::size_t *);
+
+static const tu_function functions[] = {
+#define MULTI_TU(i) multi_tu_##i,
+#include "multi_tu_list.hpp"
+#undef MULTI_TU
+};
+
+int main()
+{
+  static const char expected[] = "\x1b[1;31m";
+
+  for(const tu_function function : functions)
+  {
+    char buffer[cpp_sgr::style::MAX_RENDERED_SIZE];
+    std::size_t length = 0;
+    const cpp_sgr::sgr * reset = function(buffer, &length);
+
+    if(length != sizeof(expected) - 1 ||
+       std::memcmp(buffer, expected, length) != 0 || *reset != cpp_sgr::reset)
+    {
+      return -1;
+    }
+
+#ifdef __cpp_inline_variables
+    // All translation units share one definition of each constant
+    if(reset != &cpp_sgr::reset)
+    {
+      return -1;
+    }
+#endif
+  }
+
+  return 0;
+}
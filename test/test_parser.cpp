@@ -0,0 +1,144 @@
+#include <cpp_sgr/parser.hpp>
+#include <cpp_sgr/styled_buffer.hpp>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace cpp_sgr;
+
+struct run
+{
+  style rendition;
+  std::string text;
+};
+
+// Collects runs, merging those split across chunks
+struct collector
+{
+  std::vector<run> runs;
+
+  void operator()(const style & s, const char * text, std::size_t length)
+  {
+    if(!runs.empty() && runs.back().rendition == s)
+    {
+      runs.back().text.append(text, length);
+    }
+    else
+    {
+      runs.push_back(run{s, std::string(text, length)});
+    }
+  }
+};
+
+int main()
+{
+  std::ostringstream stream;
+  stream << bold << "a" << red_fg << "b";
+  stream << "\x1b[2K\x1b]0;title\x07" << color::fg256(208) << "c"
+         << color::bg(1, 2, 3) << "d";
+  stream << "plain " << color::bg(color::BRIGHT_RED) << "e";
+  const std::string output = stream.str();
+
+  collector whole;
+  sgr_parser parser;
+  parser.parse(output.data(), output.size(), whole);
+
+  const style expected[] = {
+    bold.getStyle(),
+    (bold + red_fg).getStyle(),
+    color::fg256(208).getStyle(),
+    (color::fg256(208) + color::bg(1, 2, 3)).getStyle(),
+    style(),
+    color::bg(color::BRIGHT_RED).getStyle()};
+  const char * texts[] = {"a", "b", "c", "d", "plain ", "e"};
+
+  if(whole.runs.size() != 6 || !parser.getStyle().empty() || parser.pending())
+  {
+    return -1;
+  }
+  for(std::size_t i = 0; i < 6; ++i)
+  {
+    if(whole.runs[i].rendition != expected[i] || whole.runs[i].text != texts[i])
+    {
+      return -1;
+    }
+  }
+
+  // Chunks of every size give the same runs
+  for(std::size_t size = 1; size <= output.size(); ++size)
+  {
+    collector chunked;
+    sgr_parser resumed;
+    for(std::size_t i = 0; i < output.size(); i += size)
+    {
+      resumed.parse(output.data() + i, std::min(size, output.size() - i),
+                    chunked);
+    }
+    if(chunked.runs.size() != whole.runs.size())
+    {
+      return -1;
+    }
+    for(std::size_t i = 0; i < chunked.runs.size(); ++i)
+    {
+      if(chunked.runs[i].rendition != whole.runs[i].rendition ||
+         chunked.runs[i].text != whole.runs[i].text)
+      {
+        return -1;
+      }
+    }
+  }
+
+  // Runs can be rendered again
+  styled_buffer restyled;
+  for(const run & r : whole.runs)
+  {
+    restyled.append(sgr(r.rendition), r.text);
+  }
+  collector again;
+  sgr_parser reparser;
+  const std::string rendered = restyled.str();
+  reparser.parse(rendered.data(), rendered.size(), again);
+  if(again.runs.size() != whole.runs.size())
+  {
+    return -1;
+  }
+
+  // Pathological parameter lists are bounded
+  std::string flood = "\x1b[1";
+  for(int i = 0; i < 10000; ++i)
+  {
+    flood += ";31";
+  }
+  flood += "mx\x1b[38;2;999999;0;0;4my";
+  collector bounded;
+  sgr_parser limited;
+  limited.parse(flood.data(), flood.size(), bounded);
+  if(bounded.runs.size() != 2 ||
+     bounded.runs[0].rendition != (bold + red_fg).getStyle() ||
+     bounded.runs[1].rendition != (bold + red_fg + underline).getStyle())
+  {
+    return -1;
+  }
+
+  // Colon sub-parameters are read as a group, with or without color space
+  const std::string itu =
+    "\x1b[38:2::1:2:3ma\x1b[48:2:0:4:5:6;4mb\x1b[38:5:208;4:0mc"
+    "\x1b[0;38:2:7:8:9;1md";
+  collector grouped;
+  sgr_parser colons;
+  colons.parse(itu.data(), itu.size(), grouped);
+  const sgr fg123 = color::fg(1, 2, 3);
+  const sgr bg456 = color::bg(4, 5, 6);
+  if(grouped.runs.size() != 4 ||
+     grouped.runs[0].rendition != fg123.getStyle() ||
+     grouped.runs[1].rendition != (fg123 + bg456 + underline).getStyle() ||
+     grouped.runs[2].rendition != (color::fg256(208) + bg456).getStyle() ||
+     grouped.runs[3].rendition != (color::fg(7, 8, 9) + bold).getStyle())
+  {
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <cpp_sgr/sgr.hpp>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+using namespace cpp_sgr;
+
+int main()
+{
+  // Palette colors map to themselves
+  if(nearest_indexed(rgb{0, 0, 0}) != 16 ||
+     nearest_indexed(rgb{255, 0, 0}) != 196 ||
+     nearest_indexed(rgb{95, 135, 175}) != 67 ||
+     nearest_indexed(rgb{255, 255, 255}) != 231 ||
+     nearest_indexed(rgb{238, 238, 238}) != 255)
+  {
+    return -1;
+  }
+
+  if(nearest_ansi(rgb{0, 0, 0}) != color::BLACK ||
+     nearest_ansi(rgb{205, 0, 0}) != color::RED ||
+     nearest_ansi(rgb{255, 0, 0}) != color::BRIGHT_RED ||
+     nearest_ansi(rgb{0, 0, 238}) != color::BLUE ||
+     nearest_ansi(rgb{255, 255, 255}) != color::BRIGHT_WHITE)
+  {
+    return -1;
+  }
+
+  // Bulk conversions agree with single ones
+  const rgb values[] = {{12, 200, 99}, {250, 128, 0}, {3, 3, 3}, {90, 0, 190}};
+  const std::size_t count = sizeof(values) / sizeof(values[0]);
+  std::uint8_t indices[count];
+  color::ANSIColor codes[count];
+  nearest_indexed(values, count, indices);
+  nearest_ansi(values, count, codes);
+  for(std::size_t i = 0; i < count; ++i)
+  {
+    if(indices[i] != nearest_indexed(values[i]) ||
+       codes[i] != nearest_ansi(values[i]))
+    {
+      return -1;
+    }
+  }
+
+  // Styles keep their attributes and only lose depth
+  const sgr s = bold + color::fg(255, 0, 0) + color::bg256(9);
+  if(s.quantized(TRUECOLOR) != s ||
+     s.quantized(INDEXED_256) !=
+       bold + color::fg256(196) + color::bg256(9) ||
+     s.quantized(ANSI_16) !=
+       bold + color::fg(color::BRIGHT_RED) + color::bg(color::BRIGHT_RED) ||
+     s.quantized(MONOCHROME) != bold ||
+     red_fg.quantized(INDEXED_256) != red_fg)
+  {
+    return -1;
+  }
+
+  style styles[] = {s.getStyle(), color::bg(0, 0, 238).getStyle()};
+  quantize(styles, 2, ANSI_16);
+  if(styles[0] != s.quantized(ANSI_16).getStyle() ||
+     styles[1] != color::bg(color::BLUE).getStyle())
+  {
+    return -1;
+  }
+
+  // Streams quantize every insertion
+  std::ostringstream stream;
+  color_depth(stream, INDEXED_256);
+  stream << bold << color::fg(255, 0, 0) << "x";
+  if(stream.str() != "\x1b[1m\x1b[38;5;196mx\x1b[0m")
+  {
+    return -1;
+  }
+
+  stream.str("");
+  color_depth(stream, ANSI_16);
+  stream << static_sgr<48, 2, 255, 0, 0>() << "y";
+  if(stream.str() != "\x1b[101my\x1b[0m")
+  {
+    return -1;
+  }
+
+  stream.str("");
+  color_depth(stream, TRUECOLOR);
+  stream << color::fg(1, 2, 3) << "z";
+  if(stream.str() != "\x1b[38;2;1;2;3mz\x1b[0m")
+  {
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include <cpp_sgr/registry.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cpp_sgr;
+
+static bool matches(const style_registry & registry, std::uint16_t id,
+                    const sgr & s)
+{
+  return registry.getStyle(id) == s.getStyle() &&
+         std::string(registry.data(id), registry.size(id)) == s.toString();
+}
+
+int main()
+{
+  style_registry & global = style_registry::global();
+  const std::uint16_t boldId = intern(bold);
+  if(boldId == 0 || intern(bold) != boldId || intern(red_fg) == boldId ||
+     !matches(global, boldId, bold) || global.size(0) != 0 ||
+     !global.getStyle(0).empty())
+  {
+    return -1;
+  }
+
+  // Concurrent interning and lookup agree on ids and bytes
+  style_registry shared;
+  std::atomic<bool> failed(false);
+  std::vector<std::thread> threads;
+  std::vector<std::uint16_t> ids[4];
+  for(int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&shared, &failed, &ids, t]() {
+      for(int i = 0; i < 1000; ++i)
+      {
+        const int n = (i * (t + 1)) % 1000;
+        const sgr s = color::fg256(n % 256) + color::bg256(n / 4);
+        const std::uint16_t id = shared.intern(s);
+        if(!matches(shared, id, s))
+        {
+          failed = true;
+        }
+        ids[t].push_back(id);
+      }
+    });
+  }
+  for(std::thread & thread : threads)
+  {
+    thread.join();
+  }
+  if(failed || shared.registered() != 1001)
+  {
+    return -1;
+  }
+  for(int i = 0; i < 1000; ++i)
+  {
+    if(ids[0][static_cast<std::size_t>(i)] !=
+       shared.intern(color::fg256(i % 256) + color::bg256(i / 4)))
+    {
+      return -1;
+    }
+  }
+
+  // Registries are bounded at 65536 styles
+  std::unique_ptr<style_registry> full(new style_registry());
+  for(int i = 1; i < 65536; ++i)
+  {
+    full->intern(color::fg(i >> 8, i & 0xFF, 0));
+  }
+  if(!matches(*full, 65535, color::fg(255, 255, 0)))
+  {
+    return -1;
+  }
+  try
+  {
+    full->intern(color::fg(0, 0, 1));
+    return -1;
+  }
+  catch(const style_registry_full &)
+  {
+  }
+
+  return 0;
+}
@@ -0,0 +1,61 @@
+#include <cpp_sgr/sgr.hpp>
+
+#include <regex>
+#include <sstream>
+#include <string>
+
+using namespace cpp_sgr;
+
+int main()
+{
+  const sgr samples[] = {reset,
+                         bold,
+                         b_white_bg,
+                         (bold, overline, red_fg, b_blue_bg),
+                         color::fg256(7) + color::bg256(255),
+                         color::fg(255, 255, 255) + color::bg(0, 10, 100),
+                         reset + faint + encircle + color::fg(1, 22, 133)};
+
+  for(const sgr & s : samples)
+  {
+    const std::string expected = s.toString();
+
+    char buffer[style::MAX_RENDERED_SIZE];
+    char * end = s.writeTo(buffer);
+    if(s.renderedSize() != expected.size() ||
+       std::string(buffer, end) != expected)
+    {
+      return -1;
+    }
+
+    const rendered_style rendered = s.render();
+    if(std::string(rendered.begin(), rendered.end()) != expected)
+    {
+      return -1;
+    }
+
+    std::string appended = "x";
+    appended.reserve(128);
+    const auto capacity = appended.capacity();
+    s.appendTo(appended);
+    if(appended != "x" + expected || appended.capacity() != capacity)
+    {
+      return -1;
+    }
+  }
+
+  // Color SGRs inserted mid-chain must not reset the chain
+  const std::regex chk_regex(
+    R"REGEX(\x1b\[1mBold \x1b\[38;2;1;2;3mand colored\x1b\[0m)REGEX");
+
+  std::ostringstream stream;
+
+  stream << bold << "Bold " << color::fg(1, 2, 3) << "and colored";
+
+  if(!std::regex_match(stream.str(), chk_regex))
+  {
+    return -1;
+  }
+
+  return 0;
+}
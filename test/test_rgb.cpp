@@ -0,0 +1,81 @@
+#include <cpp_sgr/sgr.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace cpp_sgr;
+
+static std::string expected_params(int offset, int r, int g, int b)
+{
+  return std::to_string(38 + offset) + ";2;" + std::to_string(r) + ";" +
+         std::to_string(g) + ";" + std::to_string(b);
+}
+
+int main()
+{
+  // Every component value, in every position
+  for(int v = 0; v <= 255; ++v)
+  {
+    const int w = 255 - v;
+    const rgb value = {static_cast<std::uint8_t>(v),
+                       static_cast<std::uint8_t>(w),
+                       static_cast<std::uint8_t>(v / 3)};
+
+    char buffer[style::RGB_PARAMS_CAPACITY];
+    char * end = style::writeRGB(buffer, value, true);
+    if(std::string(buffer, end) != expected_params(0, v, w, v / 3))
+    {
+      return -1;
+    }
+    end = style::writeRGB(buffer, value, false);
+    if(std::string(buffer, end) != expected_params(10, v, w, v / 3))
+    {
+      return -1;
+    }
+
+    if(color::fg(value) != color::fg(v, w, v / 3) ||
+       color::bg(value).toString() !=
+         "\x1b[" + expected_params(10, v, w, v / 3) + "m" ||
+       color::fg256(v).toString() != "\x1b[38;5;" + std::to_string(v) + "m")
+    {
+      return -1;
+    }
+  }
+
+  // Batch encoding writes complete sequences back to back
+  const rgb values[] = {{0, 0, 0}, {255, 255, 255}, {1, 20, 200}, {9, 99, 0}};
+  const std::size_t count = sizeof(values) / sizeof(values[0]);
+
+  std::vector<char> buffer(count * style::RGB_SEQUENCE_CAPACITY);
+  std::size_t ends[count];
+  char * end =
+    style::writeRGBSequences(buffer.data(), values, count, false, ends);
+
+  std::string expected;
+  for(std::size_t i = 0; i < count; ++i)
+  {
+    expected += color::bg(values[i]).toString();
+    if(ends[i] != expected.size())
+    {
+      return -1;
+    }
+  }
+  if(std::string(buffer.data(), end) != expected)
+  {
+    return -1;
+  }
+
+  // Components are range checked before anything is encoded
+  try
+  {
+    color::fg(0, 256, 0);
+    return -1;
+  }
+  catch(const invalid_color_component &)
+  {
+  }
+
+  return 0;
+}
@@ -0,0 +1,38 @@
+#include <cpp_sgr/sgr.hpp>
+
+#include <regex>
+#include <sstream>
+#include <string>
+
+using namespace cpp_sgr;
+
+using bold_red = static_sgr<sgr::BOLD, color::RED>;
+
+static_assert(bold_red::size() == 7, "static_sgr size must be constant");
+static_assert(static_sgr<38, 2, 255, 0, 128>::size() == 17,
+              "static_sgr size must be constant");
+
+int main()
+{
+  const std::regex chk_regex(
+    R"REGEX(\x1b\[1;31mBold red string\x1b\[4mUnderlined\x1b\[0m)REGEX");
+
+  std::ostringstream stream;
+
+  stream << bold_red() << "Bold red string" << static_sgr<sgr::UNDERLINE>()
+         << "Underlined";
+
+  const std::string target = stream.str();
+
+  if(!std::regex_match(target, chk_regex))
+  {
+    return -1;
+  }
+
+  if(bold_red().toString() != (bold, red_fg).toString())
+  {
+    return -1;
+  }
+
+  return 0;
+}
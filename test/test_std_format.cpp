@@ -0,0 +1,64 @@
+#include <cpp_sgr/format.hpp>
+
+#if CPP_SGR_HAS_FORMAT
+
+#include <cstddef>
+#include <format>
+#include <string>
+
+using namespace cpp_sgr;
+
+int main()
+{
+  if(std::format("{}x{}", bold + red_fg, reset) != "\x1b[1;31mx\x1b[0m")
+  {
+    return -1;
+  }
+
+  if(std::format("[{:>4}] {}", styled(green_fg, 42), styled(bold, "ok")) !=
+     "[\x1b[32m  42\x1b[0m] \x1b[1mok\x1b[0m")
+  {
+    return -1;
+  }
+
+  // Types derived from sgr and compile-time SGRs have formatters too
+  if(std::format("{}{}", color::fg(1, 2, 3), static_sgr<sgr::BOLD>()) !=
+     "\x1b[38;2;1;2;3m\x1b[1m")
+  {
+    return -1;
+  }
+
+  if(std::format("<{}>", styled(red_fg, "x=", 1, ' ', 2.5)) !=
+     "<\x1b[31mx=1 2.5\x1b[0m>")
+  {
+    return -1;
+  }
+
+  // An empty style formats just the value
+  if(std::format("{:03}", styled(style(), 7)) != "007")
+  {
+    return -1;
+  }
+
+  // format_to_n truncates without any temporary string
+  char buffer[8];
+  const auto result =
+    std::format_to_n(buffer, sizeof(buffer), "{}", styled(red_fg, 12345));
+  if(result.size != 14 ||
+     std::string(buffer, sizeof(buffer)) != std::string("\x1b[31m123"))
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+#else
+
+// std::format is unavailable; report the test as skipped
+int main()
+{
+  return 77;
+}
+
+#endif
@@ -0,0 +1,80 @@
+#include <cpp_sgr/sgr.hpp>
+#include <cpp_sgr/strip.hpp>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+using namespace cpp_sgr;
+
+static const std::string escaped =
+  (bold, red_fg).toString() + "error" + reset.toString() + ": " +
+  color::fg(1, 2, 3).toString() + "\x1b[2K\x1b[?25l" +
+  "\x1b]8;;http://example.com\x1b\\link\x1b]8;;\x1b\\ " +
+  "\x1b]0;title\x07\x1b(Bdone\x1b=\n";
+static const std::string plain = "error: link done\n";
+
+int main()
+{
+  if(strip_escapes(escaped) != plain)
+  {
+    return -1;
+  }
+
+  // Filtering in place
+  std::string buffer = escaped;
+  buffer.resize(strip_escapes(&buffer[0], buffer.size(), &buffer[0]));
+  if(buffer != plain)
+  {
+    return -1;
+  }
+
+  // Sequences split across chunks of every size are removed entirely
+  for(std::size_t size = 1; size <= escaped.size(); ++size)
+  {
+    escape_stripper stripper;
+    std::string result;
+    for(std::size_t i = 0; i < escaped.size(); i += size)
+    {
+      const std::size_t length = std::min(size, escaped.size() - i);
+      stripper.strip(escaped.data() + i, length, result);
+    }
+    if(result != plain || stripper.pending())
+    {
+      return -1;
+    }
+  }
+
+  // Control characters abort sequences and are kept
+  if(strip_escapes(std::string("\x1b[1\nx\x1b[\x1b[31my")) != "\nxy")
+  {
+    return -1;
+  }
+
+  // Escapes at every offset of a long buffer
+  std::string text;
+  std::string expected;
+  for(int i = 0; i < 300; ++i)
+  {
+    const std::string run(static_cast<std::size_t>(i % 37), 'a' + i % 26);
+    text += run + color::fg256(i % 256).toString();
+    expected += run;
+  }
+  if(strip_escapes(text) != expected)
+  {
+    return -1;
+  }
+
+  // Streams write through the stripping buffer unchanged but for escapes
+  std::ostringstream sink;
+  stripping_buffer filter(sink.rdbuf());
+  std::ostream stream(&filter);
+  stream << bold << "plain " << 42;
+  stream << '\n' << std::flush;
+  if(sink.str() != "plain 42\n")
+  {
+    return -1;
+  }
+
+  return 0;
+}
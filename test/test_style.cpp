@@ -0,0 +1,65 @@
+#include <cpp_sgr/sgr.hpp>
+
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+
+using namespace cpp_sgr;
+
+static_assert(sizeof(style) <= 16, "style must stay compact");
+static_assert(std::is_trivially_copyable<style>::value,
+              "style must be trivially copyable");
+static_assert(std::is_trivially_copyable<sgr>::value,
+              "sgr must be trivially copyable");
+static_assert((sgr(sgr::BOLD) + sgr(sgr::ITALIC)).getStyle().has(sgr::ITALIC),
+              "styles must merge at compile time");
+
+int main()
+{
+  // Attributes render in code order, followed by foreground and background
+  if((white_bg, red_fg, bold).toString() != "\x1b[1;31;47m")
+  {
+    return -1;
+  }
+
+  // Later colors replace earlier ones, attributes accumulate
+  if((red_fg + blue_fg + underline + bold) != (bold, underline, blue_fg))
+  {
+    return -1;
+  }
+
+  // A reset discards everything before it
+  if((bold + reset + italic).toString() != "\x1b[0;3m")
+  {
+    return -1;
+  }
+
+  if((color::fg(255, 0, 128) + color::bg256(17)).toString() !=
+     "\x1b[38;2;255;0;128;48;5;17m")
+  {
+    return -1;
+  }
+
+  if(b_cyan_bg.toString() != "\x1b[106m" || style().toString() != "")
+  {
+    return -1;
+  }
+
+  std::unordered_set<sgr> styles{bold, bold + red_fg, red_fg + bold, reset};
+  if(styles.size() != 3 || std::hash<sgr>()(bold) != bold.getStyle().hash())
+  {
+    return -1;
+  }
+
+  try
+  {
+    color::fg(0, 256, 0);
+    return -1;
+  }
+  catch(const invalid_color_component &)
+  {
+  }
+
+  return 0;
+}
@@ -0,0 +1,78 @@
+#include <cpp_sgr/sgr.hpp>
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+using namespace cpp_sgr;
+
+int main()
+{
+  std::ostringstream stream;
+
+  // Formatting state applies to the value, and survives the insertion
+  stream << std::hex << std::setw(4) << std::setfill('0')
+         << styled(bold + red_fg, 255) << ' ' << 16;
+  if(stream.str() != "\x1b[1;31m00ff\x1b[0m 10" || !stream.good())
+  {
+    return -1;
+  }
+
+  stream.str("");
+  stream << std::dec;
+  const int x = 3, y = 4;
+  stream << styled(green_fg, "x=", x, " y=", y) << styled(reset, "!");
+  if(stream.str() != "\x1b[32mx=3 y=4\x1b[0m!")
+  {
+    return -1;
+  }
+
+  // Colors are fit into the stream's depth
+  stream.str("");
+  color_depth(stream, ANSI_16);
+  stream << styled(color::fg(250, 10, 10), 'a');
+  color_depth(stream, PLAIN);
+  stream << styled(bold, 'b', 'c');
+  if(stream.str() != "\x1b[91ma\x1b[0mbc")
+  {
+    return -1;
+  }
+  color_depth(stream, TRUECOLOR);
+
+  // Tracked streams behave like a chain
+  std::ostringstream tracked;
+  track_style(tracked);
+  tracked << styled(bold, "t") << styled(bold, "u");
+  if(tracked.str() != "\x1b[1mt\x1b[0m\x1b[1mu\x1b[0m")
+  {
+    return -1;
+  }
+
+  // A tracked stream returns to its previous rendition after the value
+  tracked.str("");
+  tracked << bold;
+  tracked << "a" << styled(red_fg, "b") << "c";
+  if(tracked.str() != "\x1b[1ma\x1b[0;31mb\x1b[0;1mc")
+  {
+    return -1;
+  }
+  track_style(tracked, false);
+
+  // Atomic chains take precedence over tracking
+  std::ostringstream both;
+  track_style(both);
+  atomic_chains(both);
+  both << styled(bold, "a") << "b";
+  if(both.str() != "\x1b[1ma\x1b[0mb")
+  {
+    return -1;
+  }
+  atomic_chains(both, false);
+  both << styled(red_fg, "c");
+  if(both.str() != "\x1b[1ma\x1b[0mb\x1b[31mc\x1b[0m")
+  {
+    return -1;
+  }
+
+  return 0;
+}
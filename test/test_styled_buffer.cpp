@@ -0,0 +1,111 @@
+#include <cpp_sgr/styled_buffer.hpp>
+
+#include <cstdio>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+using namespace cpp_sgr;
+
+static const std::string expected =
+  "\x1b[1mStatus: \x1b[0;32mok, ok\x1b[0m | \x1b[48;2;0;0;255mdone\x1b[0m";
+
+static std::string read_back(std::FILE * file)
+{
+  std::rewind(file);
+  std::string result;
+  char chunk[64];
+  std::size_t count;
+  while((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+  {
+    result.append(chunk, count);
+  }
+  return result;
+}
+
+// Stream buffer recording how many calls wrote to it
+class counting_buffer : public std::streambuf
+{
+public:
+  std::string text;
+  int calls = 0;
+
+protected:
+  std::streamsize xsputn(const char * s, std::streamsize count) override
+  {
+    ++calls;
+    text.append(s, static_cast<std::size_t>(count));
+    return count;
+  }
+
+  int_type overflow(int_type c) override
+  {
+    ++calls;
+    text += traits_type::to_char_type(c);
+    return c;
+  }
+};
+
+int main()
+{
+  styled_buffer buffer(256);
+
+  buffer.append(bold, "Status: ")
+    .append(green_fg, "ok")
+    .append(green_fg, ", ok")
+    .append(" | ")
+    .append(color::bg(0, 0, 255), "done");
+
+  if(buffer.str() != expected || buffer.size() != expected.size())
+  {
+    return -1;
+  }
+
+  std::ostringstream stream;
+  stream << buffer;
+  if(stream.str() != expected || buffer.str() != expected)
+  {
+    return -1;
+  }
+
+  const styled_buffer & constant = buffer;
+  std::ostringstream temporary;
+  temporary << constant << (styled_buffer().append(bold, "x"));
+  if(temporary.str() != expected + "\x1b[1mx\x1b[0m")
+  {
+    return -1;
+  }
+
+  counting_buffer counted;
+  std::ostream counted_stream(&counted);
+  buffer.writeTo(counted_stream);
+  if(counted.calls != 1 || counted.text != expected)
+  {
+    return -1;
+  }
+
+  std::FILE * file = std::tmpfile();
+  if(!file || !buffer.writeTo(file) || read_back(file) != expected)
+  {
+    return -1;
+  }
+  std::fclose(file);
+
+#ifndef _WIN32
+  file = std::tmpfile();
+  if(!file || !buffer.writeTo(fileno(file)) || read_back(file) != expected)
+  {
+    return -1;
+  }
+  std::fclose(file);
+#endif
+
+  buffer.clear();
+  buffer.append("plain");
+  if(buffer.str() != "plain")
+  {
+    return -1;
+  }
+
+  return 0;
+}
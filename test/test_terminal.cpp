@@ -0,0 +1,206 @@
+#include <cpp_sgr/terminal.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace cpp_sgr;
+
+#ifndef _WIN32
+// Build a compiled terminfo entry with the given "colors" capability
+static std::vector<unsigned char> entry(bool extended, long colors)
+{
+  const std::string names = "fake|fake terminal";
+  const unsigned bools = 3;
+  const unsigned numbers = colors == -1 ? 5 : 15;
+  std::vector<unsigned char> data;
+  const auto put16 = [&data](unsigned value) {
+    data.push_back(static_cast<unsigned char>(value & 0xFF));
+    data.push_back(static_cast<unsigned char>(value >> 8 & 0xFF));
+  };
+  put16(extended ? 01036 : 0432);
+  put16(static_cast<unsigned>(names.size() + 1));
+  put16(bools);
+  put16(numbers);
+  put16(0);
+  put16(0);
+  data.insert(data.end(), names.begin(), names.end());
+  data.push_back(0);
+  data.insert(data.end(), bools, 1);
+  if(data.size() & 1)
+  {
+    data.push_back(0);
+  }
+  for(unsigned i = 0; i < numbers; ++i)
+  {
+    const unsigned long value =
+      i == 13 ? static_cast<unsigned long>(colors) : 0xFFFFFFFFul;
+    put16(static_cast<unsigned>(value & 0xFFFF));
+    if(extended)
+    {
+      put16(static_cast<unsigned>(value >> 16 & 0xFFFF));
+    }
+  }
+  return data;
+}
+
+static bool install(const std::string & dir, const char * name,
+                    const std::vector<unsigned char> & data)
+{
+  const std::string sub = dir + "/" + name[0];
+  mkdir(sub.c_str(), 0700);
+  std::FILE * file = std::fopen((sub + "/" + name).c_str(), "wb");
+  if(!file)
+  {
+    return false;
+  }
+  std::fwrite(data.data(), 1, data.size(), file);
+  return std::fclose(file) == 0;
+}
+#endif
+
+int main()
+{
+#ifndef _WIN32
+  // Both terminfo formats
+  std::vector<unsigned char> legacy = entry(false, 256);
+  std::vector<unsigned char> extended = entry(true, 1L << 24);
+  std::vector<unsigned char> none = entry(false, -1);
+  if(detail::parse_terminfo_colors(legacy.data(), legacy.size()) != 256 ||
+     detail::parse_terminfo_colors(extended.data(), extended.size()) !=
+       (1L << 24) ||
+     detail::parse_terminfo_colors(none.data(), none.size()) != -1 ||
+     detail::parse_terminfo_colors(legacy.data(), 20) != -2)
+  {
+    return -1;
+  }
+
+  char dir[] = "/tmp/cpp_sgr_terminfoXXXXXX";
+  if(!mkdtemp(dir) || !install(dir, "fake-256", legacy) ||
+     !install(dir, "fake-direct", extended) || !install(dir, "fake-mono", none))
+  {
+    return -1;
+  }
+  setenv("TERMINFO", dir, 1);
+  unsetenv("COLORTERM");
+  unsetenv("FORCE_COLOR");
+  unsetenv("NO_COLOR");
+
+  // A pseudo-terminal is a terminal; a pipe is not
+  const int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if(master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+  {
+    return -1;
+  }
+  const int tty = open(ptsname(master), O_RDWR | O_NOCTTY);
+  int pipes[2];
+  if(tty < 0 || pipe(pipes) != 0)
+  {
+    return -1;
+  }
+
+  setenv("TERM", "fake-256", 1);
+  if(detail::probe_terminal_depth(tty) != INDEXED_256 ||
+     detail::probe_terminal_depth(pipes[1]) != PLAIN)
+  {
+    return -1;
+  }
+  setenv("TERM", "fake-direct", 1);
+  if(detail::probe_terminal_depth(tty) != TRUECOLOR)
+  {
+    return -1;
+  }
+  setenv("TERM", "fake-mono", 1);
+  if(detail::probe_terminal_depth(tty) != MONOCHROME)
+  {
+    return -1;
+  }
+  setenv("COLORTERM", "truecolor", 1);
+  if(detail::probe_terminal_depth(tty) != TRUECOLOR)
+  {
+    return -1;
+  }
+  unsetenv("COLORTERM");
+  setenv("TERM", "dumb", 1);
+  if(detail::probe_terminal_depth(tty) != PLAIN)
+  {
+    return -1;
+  }
+  setenv("TERM", "unknown-256color", 1);
+  if(detail::probe_terminal_depth(tty) != INDEXED_256)
+  {
+    return -1;
+  }
+
+  setenv("NO_COLOR", "1", 1);
+  if(detail::probe_terminal_depth(tty) != MONOCHROME ||
+     detail::probe_terminal_depth(pipes[1]) != PLAIN)
+  {
+    return -1;
+  }
+  setenv("FORCE_COLOR", "2", 1);
+  if(detail::probe_terminal_depth(pipes[1]) != INDEXED_256)
+  {
+    return -1;
+  }
+  setenv("FORCE_COLOR", "0", 1);
+  if(detail::probe_terminal_depth(tty) != PLAIN)
+  {
+    return -1;
+  }
+  unsetenv("FORCE_COLOR");
+  unsetenv("NO_COLOR");
+
+  // Results are cached until cleared, and can be overridden
+  setenv("TERM", "fake-256", 1);
+  if(terminal_depth(tty) != INDEXED_256)
+  {
+    return -1;
+  }
+  setenv("TERM", "fake-direct", 1);
+  if(terminal_depth(tty) != INDEXED_256)
+  {
+    return -1;
+  }
+  clear_terminal_depth(tty);
+  if(terminal_depth(tty) != TRUECOLOR)
+  {
+    return -1;
+  }
+  set_terminal_depth(tty, ANSI_16);
+  if(terminal_depth(tty) != ANSI_16)
+  {
+    return -1;
+  }
+
+  // Streams writing to a non-terminal get no escape sequences
+  std::ostringstream stream;
+  detect_color_depth(stream, pipes[1]);
+  stream << bold << color::fg(1, 2, 3) << "plain";
+  if(stream.str() != "plain")
+  {
+    return -1;
+  }
+
+  close(tty);
+  close(master);
+  close(pipes[0]);
+  close(pipes[1]);
+  for(const char * name : {"fake-256", "fake-direct", "fake-mono"})
+  {
+    std::remove((std::string(dir) + "/f/" + name).c_str());
+  }
+  rmdir((std::string(dir) + "/f").c_str());
+  rmdir(dir);
+#endif
+
+  return 0;
+}
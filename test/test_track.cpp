@@ -0,0 +1,65 @@
+#include <cpp_sgr/sgr.hpp>
+
+#include <sstream>
+#include <string>
+
+using namespace cpp_sgr;
+
+static std::string transition(const sgr & from, const sgr & to)
+{
+  char buffer[style::MAX_TRANSITION_SIZE];
+  char * end =
+    style::writeTransition(from.getStyle(), to.getStyle(), buffer);
+  return std::string(buffer, end);
+}
+
+int main()
+{
+  // Attributes are turned off individually when that is shorter
+  if(transition(bold + red_fg, red_fg) != "\x1b[22m" ||
+     transition(bold + faint + red_fg, faint + red_fg) != "\x1b[22;2m" ||
+     transition((bold, underline, blue_bg, red_fg), (bold, blue_bg, green_fg)) !=
+       "\x1b[24;32m")
+  {
+    return -1;
+  }
+
+  // ... and reset when that is shorter
+  if(transition(bold + red_fg, italic) != "\x1b[0;3m" ||
+     transition(underline + blue_bg, blue_fg) != "\x1b[0;34m" ||
+     transition(italic, reset) != "\x1b[0m" ||
+     transition(red_fg, red_fg) != "")
+  {
+    return -1;
+  }
+
+  std::ostringstream stream;
+  track_style(stream);
+
+  stream << red_fg << "a\n";
+  stream << red_fg << "b\n";
+  stream << (red_fg, bold) << "c";
+  stream << italic << "d" << static_sgr<sgr::UNDERLINE>() << "e"
+         << static_sgr<23>() << "f";
+  track_style(stream, false);
+  stream << "g";
+
+  if(stream.str() !=
+     "\x1b[31ma\nb\n\x1b[1mc\x1b[0;3md\x1b[4me\x1b[23mf\x1b[0mg")
+  {
+    return -1;
+  }
+
+  // Untracked streams are unaffected
+  std::ostringstream untracked;
+
+  untracked << red_fg << "a";
+  untracked << red_fg << "b";
+
+  if(untracked.str() != "\x1b[31ma\x1b[0m\x1b[31mb\x1b[0m")
+  {
+    return -1;
+  }
+
+  return 0;
+}
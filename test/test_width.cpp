@@ -0,0 +1,79 @@
+#include <cpp_sgr/sgr.hpp>
+#include <cpp_sgr/width.hpp>
+
+#include <cstddef>
+#include <string>
+
+using namespace cpp_sgr;
+
+static const std::string red = red_fg.toString();
+static const std::string off = reset.toString();
+
+int main()
+{
+  // Plain ASCII, long enough for the vectorized path
+  const std::string ascii(100, 'a');
+  if(display_width(ascii) != 100 || display_width("") != 0)
+  {
+    return -1;
+  }
+
+  // Escape sequences, wide, combining, zero-width and control characters
+  const std::string text = red + "\xe4\xbd\xa0\xe5\xa5\xbd" + off + " e\xcc\x81" +
+    "\xe2\x80\x8b\t\x1b]8;;http://x\x07link\x1b]8;;\x1b\\";
+  if(display_width(text) != 4 + 1 + 1 + 4)
+  {
+    return -1;
+  }
+
+  // Malformed UTF-8 takes a column per byte
+  if(display_width(std::string("\xff\xc3(\xe2\x82")) != 5)
+  {
+    return -1;
+  }
+
+  // Padding counts only visible columns
+  const std::string word = red + "ok" + off;
+  if(pad(word, 5) != word + "   " || pad(word, 5, ALIGN_RIGHT) != "   " + word ||
+     center(word, 5, '*') != "*" + word + "**" || pad(word, 1) != word)
+  {
+    return -1;
+  }
+
+  // Truncation keeps the escape sequences of the cut part
+  const std::string long_word = red + "abcdef" + off + "gh";
+  if(truncate(long_word, 8) != long_word ||
+     truncate(long_word, 4) != red + "abc\xe2\x80\xa6" + off ||
+     truncate(long_word, 4, "...") != red + "a..." + off ||
+     truncate(long_word, 2, "...") != red + "ab" + off)
+  {
+    return -1;
+  }
+
+  // A wide character that does not fit leaves a blank column
+  const std::string wide = "\xe4\xbd\xa0\xe5\xa5\xbd\xe5\x90\x97";
+  if(truncate(wide, 4) != "\xe4\xbd\xa0 \xe2\x80\xa6" ||
+     display_width(truncate(wide, 4)) != 4)
+  {
+    return -1;
+  }
+
+  // Fitting pads or truncates to exactly the width
+  if(fit(word, 4, ALIGN_RIGHT) != "  " + word ||
+     fit(long_word, 5) != red + "abcd\xe2\x80\xa6" + off ||
+     fit(wide, 7, ALIGN_CENTER) != wide + " ")
+  {
+    return -1;
+  }
+
+  std::string row;
+  fit(word.data(), word.size(), 3, row);
+  row += '|';
+  fit(long_word.data(), long_word.size(), 3, row, ALIGN_LEFT, "~");
+  if(row != word + " |" + red + "ab~" + off || display_width(row) != 7)
+  {
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""Generate include/cpp_sgr/width_table.hpp from Python's unicodedata.
+
+Usage: tools/generate_width_table.py > include/cpp_sgr/width_table.hpp
+
+The table is generated from the Unicode version in UNICODE_VERSION. The
+script refuses to run with a Python whose unicodedata implements another
+version, so the table only changes when UNICODE_VERSION is updated on
+purpose.
+
+Code points below 0x40000 are covered by a two-level table: the first level
+maps each block of 256 code points to a deduplicated second-level block,
+which packs the widths of its code points into 2 bits each.
+"""
+
+import os
+import sys
+import unicodedata
+
+UNICODE_VERSION = '14.0.0'
+LIMIT = 0x40000
+BLOCK = 256
+
+
+def width(cp):
+    if 0xD800 <= cp <= 0xDFFF:
+        return 1
+    c = chr(cp)
+    category = unicodedata.category(c)
+    if category == 'Cc':
+        return 0
+    if category in ('Mn', 'Me') or (category == 'Cf' and cp != 0xAD):
+        return 0
+    if 0x1160 <= cp <= 0x11FF:
+        return 0   # Hangul Jamo medial vowels and final consonants
+    if unicodedata.east_asian_width(c) in ('W', 'F'):
+        return 2
+    if 0x20000 <= cp <= 0x2FFFD or 0x30000 <= cp <= 0x3FFFD:
+        return 2   # CJK ideograph planes, including unassigned code points
+    return 1
+
+
+def main():
+    if unicodedata.unidata_version != UNICODE_VERSION:
+        sys.exit('%s: Python provides Unicode %s data, expected %s; run it '
+                 'with a matching Python or update UNICODE_VERSION'
+                 % (sys.argv[0], unicodedata.unidata_version,
+                    UNICODE_VERSION))
+
+    blocks = []
+    index = {}
+    stage1 = []
+    for start in range(0, LIMIT, BLOCK):
+        packed = bytearray(BLOCK // 4)
+        for offset in range(BLOCK):
+            packed[offset // 4] |= width(start + offset) << (offset % 4 * 2)
+        key = bytes(packed)
+        if key not in index:
+            index[key] = len(blocks)
+            blocks.append(key)
+        stage1.append(index[key])
+    assert len(blocks) <= 256
+
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    with open(os.path.join(root, 'include', 'cpp_sgr',
+                           'styled_buffer.hpp')) as f:
+        license_lines = f.read().split('\n')[6:31]
+
+    out = sys.stdout
+    out.write('/**\n *  cpp_sgr display width table.\n *\n'
+              ' *  @file width_table.hpp\n */\n\n')
+    out.write('\n'.join(license_lines) + '\n\n')
+    out.write('#ifndef CPP_SGR_WIDTH_TABLE_HPP\n'
+              '#define CPP_SGR_WIDTH_TABLE_HPP\n\n'
+              '#include "config.hpp"\n\n'
+              '#include <cstdint>\n\n')
+    out.write('// Generated by tools/generate_width_table.py from Unicode %s\n'
+              '// data; do not edit.\n\n' % UNICODE_VERSION)
+    out.write('CPP_SGR_BEGIN_NAMESPACE\n\tnamespace detail\n\t{\n')
+    out.write('\t\t/**\n'
+              '\t\t * Display widths of the code points below 0x%X, packed\n'
+              '\t\t * into a two-level table of 2-bit entries.\n'
+              '\t\t */\n' % LIMIT)
+    out.write('\t\tstruct width_table\n\t\t{\n')
+    out.write('\t\t\tenum : std::uint32_t\n\t\t\t{\n'
+              '\t\t\t\tLIMIT = 0x%X,\n\t\t\t\tBLOCK_SHIFT = 8\n\t\t\t};\n\n'
+              % LIMIT)
+    out.write('\t\t\t/**\n'
+              '\t\t\t * @return Version of the Unicode data the table was\n'
+              '\t\t\t * generated from\n'
+              '\t\t\t */\n'
+              '\t\t\tstatic constexpr const char * unicode_version() noexcept\n'
+              '\t\t\t{\n'
+              '\t\t\t\treturn "%s";\n'
+              '\t\t\t}\n\n' % UNICODE_VERSION)
+    out.write('\t\t\t/**\n'
+              '\t\t\t * @param  cp Code point below LIMIT\n'
+              '\t\t\t * @return    Display width: 0, 1 or 2 columns\n'
+              '\t\t\t */\n'
+              '\t\t\tstatic unsigned lookup(const std::uint32_t cp) noexcept\n'
+              '\t\t\t{\n'
+              '\t\t\t\tconst std::uint8_t * block =\n'
+              '\t\t\t\t\tblocks()[index()[cp >> BLOCK_SHIFT]];\n'
+              '\t\t\t\tconst unsigned offset = cp & 0xFF;\n'
+              '\t\t\t\treturn block[offset >> 2] >> (offset & 3) * 2 & 3;\n'
+              '\t\t\t}\n\n')
+
+    def emit(values, indent):
+        line = indent
+        for value in values:
+            item = '0x%02X,' % value
+            if len((line + ' ' + item).expandtabs(4)) > 80:
+                out.write(line.rstrip() + '\n')
+                line = indent
+            line += item + ' '
+        out.write(line.rstrip() + '\n')
+
+    out.write('\t\t\t/**\n'
+              '\t\t\t * @return Index of the block of each 256 code points\n'
+              '\t\t\t */\n'
+              '\t\t\tstatic const std::uint8_t * index() noexcept\n'
+              '\t\t\t{\n'
+              '\t\t\t\tstatic const std::uint8_t table[%d] = {\n' % len(stage1))
+    emit(stage1, '\t\t\t\t\t')
+    out.write('\t\t\t\t};\n\t\t\t\treturn table;\n\t\t\t}\n\n')
+
+    out.write('\t\t\t/**\n'
+              '\t\t\t * @return Distinct blocks of packed widths\n'
+              '\t\t\t */\n'
+              '\t\t\tstatic const std::uint8_t (*blocks() noexcept)[%d]\n'
+              '\t\t\t{\n'
+              '\t\t\t\tstatic const std::uint8_t table[%d][%d] = {\n'
+              % (BLOCK // 4, len(blocks), BLOCK // 4))
+    for block in blocks:
+        out.write('\t\t\t\t\t{\n')
+        emit(block, '\t\t\t\t\t\t')
+        out.write('\t\t\t\t\t},\n')
+    out.write('\t\t\t\t};\n\t\t\t\treturn table;\n\t\t\t}\n')
+    out.write('\t\t};\n\t}   // namespace detail\nCPP_SGR_END_NAMESPACE\n\n'
+              '#endif /* end of include guard: CPP_SGR_WIDTH_TABLE_HPP */\n')
+
+
+if __name__ == '__main__':
+    main()